@@ -1,12 +1,21 @@
 #pragma once
 
-#if _WIN32
+#ifndef OP_COUNTERS
+#define OP_COUNTERS 0
+#endif
+
+#if _WIN32 || __linux__
 #include <stdint.h>
 #include <string.h>
 #define PROGMEM
 #define PSTR
+#if OP_COUNTERS
+#define pgm_read_byte(x) (COUNT_OP(ProgmemReadByte), *((uint8_t*)x))
+#define pgm_read_word(x) (COUNT_OP(ProgmemReadWord), *((uint16_t*)x))
+#else
 #define pgm_read_byte(x) (*((uint8_t*)x))
 #define pgm_read_word(x) (*((uint16_t*)x))
+#endif
 #define pgm_read_ptr(x) (*((uintptr_t*)x))
 #define strlen_P(x) strlen(x)
 #else
@@ -14,7 +23,7 @@
 //#define pgm_read_ptr pgm_read_word
 #endif
 
-#ifdef _WIN32
+#if _WIN32 || __linux__
 #define DISPLAY_WIDTH 128
 #define DISPLAY_HEIGHT 64
 #else
@@ -25,6 +34,35 @@
 #define TARGET_FRAMERATE 30
 #define DEV_MODE 0
 
+// Profiling zones are always on in DEV_MODE so the overlay can be shown
+#ifndef PROFILER
+#define PROFILER DEV_MODE
+#endif
+
+// AVR only: paints the stack at boot and tracks SRAM usage, reported over serial in DEV_MODE
+#ifndef MEMORY_STATS
+#if _WIN32 || __linux__
+#define MEMORY_STATS 0
+#else
+#define MEMORY_STATS DEV_MODE
+#endif
+#endif
+
+// Device only: flies the replay in ReplayData.h, written by ReplayTool, instead of reading the buttons
+#ifndef REPLAY_PLAYBACK
+#define REPLAY_PLAYBACK 0
+#endif
+
+// Makes the GameDrawInterp constants runtime settable so host tools can sweep them
+#ifndef INTERP_TUNING
+#define INTERP_TUNING 0
+#endif
+
+// Host only: checks fixed8_t / fixed16_t arithmetic for results that don't fit the raw type
+#ifndef FIXED_OVERFLOW_CHECKS
+#define FIXED_OVERFLOW_CHECKS 0
+#endif
+
 #define INPUT_LEFT 1
 #define INPUT_RIGHT 2
 #define INPUT_UP 4
@@ -37,3 +75,4 @@
 
 #define FIXED_ANGLE_MAX 256
 
+#include "OpCounters.h"
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+#include "Platform.h"
+
+// Colours 0 to 4 are drawn as 2x2 pixel blocks, lighting the pixels whose pattern entry is at most the colour
+
+const uint8_t ditherPattern1[] =
+{
+	1, 3,
+	4, 2
+};
+const uint8_t ditherPattern2[] =
+{
+	4, 2,
+	1, 3,
+};
+
+struct DitherWriter
+{
+	DitherWriter(uint8_t* inBufferPtr, const uint8_t* inDitherPattern, uint8_t inMaxWrites) :
+		bufferPtr(inBufferPtr),
+		ditherPattern(inDitherPattern),
+		writesLeft(inMaxWrites),
+		buffer1(0),
+		buffer2(0),
+		bufferPos(0),
+		writeMask(1)
+	{
+		COUNT_AT_BUFFER(bufferPtr);
+	}
+
+	bool CanWrite()
+	{
+		return writesLeft > 0;
+	}
+
+	inline void Write(uint8_t outColour)
+	{
+		COUNT_OP(DitherWrite);
+
+		// Fill in 2x2 pixels based on dither pattern
+		if (outColour >= ditherPattern[0])
+		{
+			buffer1 |= writeMask;
+		}
+		if (outColour >= ditherPattern[1])
+		{
+			buffer2 |= writeMask;
+		}
+		writeMask <<= 1;
+		if (outColour >= ditherPattern[2])
+		{
+			buffer1 |= writeMask;
+		}
+		if (outColour >= ditherPattern[3])
+		{
+			buffer2 |= writeMask;
+		}
+		writeMask <<= 1;
+
+		bufferPos++;
+		if (bufferPos == 4)
+		{
+			// Write out buffer and move on to the next 8 pixels
+			bufferPtr[0] = buffer1;
+			bufferPtr[1] = buffer2;
+			bufferPtr += DISPLAY_WIDTH;
+			writeMask = 1;
+			bufferPos = 0;
+			buffer1 = 0;
+			buffer2 = 0;
+			COUNT_AT_BUFFER(bufferPtr);
+		}
+
+		writesLeft--;
+	}
+
+	uint8_t* bufferPtr;
+	const uint8_t* ditherPattern;
+	uint8_t writesLeft;
+	uint8_t buffer1, buffer2, bufferPos, writeMask;
+};
+
+// Dither fill for every 2x2 block in a page byte, indexed by colour, for the left and right columns
+static const uint8_t ditherFillLeft[] = { 0x00, 0x55, 0x55, 0x55, 0xff };
+static const uint8_t ditherFillRight[] = { 0x00, 0x00, 0xaa, 0xff, 0xff };
+static const uint8_t blockMasks[] = { 0x03, 0x0c, 0x30, 0xc0 };
+
+// Writes one 2x2 block in place, as DitherWriter would with ditherPattern1
+inline void WriteDitherBlock(uint8_t blockX, uint8_t blockY, uint8_t colour)
+{
+	COUNT_AT(blockX * 2, blockY * 2);
+	COUNT_OP(BlockWrite);
+
+	uint8_t* bufferPtr = Platform::GetScreenBuffer() + (blockY >> 2) * DISPLAY_WIDTH + blockX * 2;
+	uint8_t mask = blockMasks[blockY & 3];
+	bufferPtr[0] = (bufferPtr[0] & ~mask) | (ditherFillLeft[colour] & mask);
+	bufferPtr[1] = (bufferPtr[1] & ~mask) | (ditherFillRight[colour] & mask);
+}
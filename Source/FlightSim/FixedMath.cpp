@@ -1,6 +1,19 @@
 #include "FixedMath.h"
 #include "Generated/LUT.h"
 
+#if FIXED_OVERFLOW_CHECKS
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <map>
+#include <vector>
+#include <algorithm>
+#if __linux__
+#include <link.h>
+#include <dlfcn.h>
+#endif
+#endif
+
 uint16_t RandomOld()
 {
 	static uint16_t randVal = 0xABC;
@@ -28,6 +41,11 @@ void SeedRandom(uint16_t seed)
 	xs = seed | 1;
 }
 
+uint16_t GetRandomState()
+{
+	return xs;
+}
+
 Matrix3x3 Matrix3x3::Identity()
 {
 	Matrix3x3 result;
@@ -121,6 +139,8 @@ Matrix3x3 Matrix3x3::Transpose() const
 
 Vector3b Matrix3x3::operator * (const Vector3b& v)
 {
+	COUNT_OP(MatrixVectorMultiply);
+
 	return Vector3b(
 		v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0],
 		v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1],
@@ -129,6 +149,8 @@ Vector3b Matrix3x3::operator * (const Vector3b& v)
 
 Vector3s Matrix3x3::operator * (const Vector3s& v)
 {
+	COUNT_OP(MatrixVectorMultiplyWide);
+
 	return Vector3s(
 		v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0],
 		v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1],
@@ -137,6 +159,8 @@ Vector3s Matrix3x3::operator * (const Vector3s& v)
 
 Matrix3x3 Matrix3x3::operator * (const Matrix3x3& other)
 {
+	COUNT_OP(MatrixMultiply);
+
 	fixed16_t temp = 0;
 	int a, b, c;
 	Matrix3x3 result;
@@ -180,3 +204,124 @@ void Matrix3x3::Normalize()
 
 }
 
+
+#if FIXED_OVERFLOW_CHECKS
+
+struct FixedOverflowSite
+{
+	const void* callSite;
+	FixedOp op;
+	uint8_t bits;
+	uint32_t count;
+};
+
+static std::map<std::pair<const void*, FixedOp>, FixedOverflowSite> overflowSites;
+static uint32_t overflowTotal;
+
+static const char* const fixedOpNames[(int)FixedOp::NumOps] =
+{
+	"Add",
+	"Subtract",
+	"Multiply",
+	"Divide",
+	"DivideByZero",
+	"Negate",
+	"Narrow",
+	"QuickDivide"
+};
+
+const char* FixedOverflow::GetOpName(FixedOp op)
+{
+	return fixedOpNames[(int)op];
+}
+
+#if __linux__
+static int GetMainLoadBias(struct dl_phdr_info* info, size_t, void* data)
+{
+	// The main program is always reported first
+	*(uintptr_t*)data = info->dlpi_addr;
+	return 1;
+}
+#endif
+
+// Source location of a call site as "function at file:line", looked up with addr2line where available
+static std::string DescribeCallSite(const void* callSite)
+{
+	char description[512];
+	snprintf(description, sizeof(description), "%p", callSite);
+
+#if __linux__
+	Dl_info info;
+	if (!dladdr(callSite, &info) || !info.dli_fname)
+		return description;
+
+	uintptr_t loadBias = 0;
+	dl_iterate_phdr(GetMainLoadBias, &loadBias);
+
+	// The return address is the instruction after the call
+	char command[512];
+	snprintf(command, sizeof(command), "addr2line -C -f -e \"%s\" %#lx 2>/dev/null", info.dli_fname,
+		(unsigned long)((uintptr_t)callSite - loadBias - 1));
+
+	FILE* pipe = popen(command, "r");
+	if (pipe)
+	{
+		char function[256] = {}, location[256] = {};
+		if (fgets(function, sizeof(function), pipe) && fgets(location, sizeof(location), pipe))
+		{
+			function[strcspn(function, "\n")] = 0;
+			location[strcspn(location, "\n")] = 0;
+			if (location[0] != '?')
+				snprintf(description, sizeof(description), "%s at %s", function, location);
+		}
+		pclose(pipe);
+	}
+#endif
+
+	return description;
+}
+
+void FixedOverflow::Report(FixedOp op, uint8_t bits, const void* callSite)
+{
+	overflowTotal++;
+
+	FixedOverflowSite& site = overflowSites[std::make_pair(callSite, op)];
+	if (site.count++ == 0)
+	{
+		site.callSite = callSite;
+		site.op = op;
+		site.bits = bits;
+		fprintf(stderr, "Fixed point %s overflowed %d bits in %s\n", GetOpName(op), bits, DescribeCallSite(callSite).c_str());
+	}
+}
+
+void FixedOverflow::Reset()
+{
+	overflowSites.clear();
+	overflowTotal = 0;
+}
+
+uint32_t FixedOverflow::GetTotal()
+{
+	return overflowTotal;
+}
+
+void FixedOverflow::Print(uint32_t numFrames)
+{
+	std::vector<FixedOverflowSite> sites;
+	for (const auto& entry : overflowSites)
+	{
+		sites.push_back(entry.second);
+	}
+	std::sort(sites.begin(), sites.end(), [](const FixedOverflowSite& a, const FixedOverflowSite& b) { return a.count > b.count; });
+
+	printf("Fixed point overflows: %u over %u frames (%.2f per frame) at %d call sites\n", overflowTotal, numFrames,
+		numFrames ? (double)overflowTotal / numFrames : 0.0, (int)sites.size());
+	for (const FixedOverflowSite& site : sites)
+	{
+		printf("  %10u %10.2f/frame  %-12s %2d bit  %s\n", site.count, numFrames ? (double)site.count / numFrames : 0.0,
+			GetOpName(site.op), site.bits, DescribeCallSite(site.callSite).c_str());
+	}
+}
+
+#endif
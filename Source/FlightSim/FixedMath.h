@@ -1,7 +1,7 @@
 #pragma once
 
 #include <stdint.h>
-#if _WIN32
+#if _WIN32 || __linux__
 #include <math.h>
 #endif
 #include "Defines.h"
@@ -24,6 +24,66 @@
 
 constexpr int FixedFractionalBits = 6;
 
+#if FIXED_OVERFLOW_CHECKS
+#if !(_WIN32 || __linux__)
+#error FIXED_OVERFLOW_CHECKS is only supported on the host
+#endif
+#include <limits>
+
+enum class FixedOp : uint8_t
+{
+	Add,
+	Subtract,
+	Multiply,
+	Divide,
+	DivideByZero,
+	Negate,
+	Narrow,				// fixed16_t to fixed8_t
+	QuickDivide,
+	NumOps
+};
+
+// Counts results that wrapped because they don't fit the raw type, by operation and call site.
+// The first wrap at each call site is logged to stderr as it happens.
+class FixedOverflow
+{
+public:
+	static void Report(FixedOp op, uint8_t bits, const void* callSite);
+	static void Reset();
+	static uint32_t GetTotal();
+	static void Print(uint32_t numFrames);
+	static const char* GetOpName(FixedOp op);
+};
+
+template <typename RawType>
+constexpr int32_t FixedCheckRange(int32_t value, FixedOp op, const void* callSite)
+{
+	return value < std::numeric_limits<RawType>::min() || value > std::numeric_limits<RawType>::max()
+		? (FixedOverflow::Report(op, sizeof(RawType) * 8, callSite), value) : value;
+}
+
+constexpr int32_t FixedCheckDivisor(int32_t divisor, uint8_t bits, const void* callSite)
+{
+	return divisor == 0 ? (FixedOverflow::Report(FixedOp::DivideByZero, bits, callSite), divisor) : divisor;
+}
+
+// The operators aren't inlined so that the return address identifies the call site
+#if _MSC_VER
+#include <intrin.h>
+#define FIXED_OPERATOR __declspec(noinline)
+#define FIXED_CALL_SITE _ReturnAddress()
+#else
+#define FIXED_OPERATOR __attribute__((noinline))
+#define FIXED_CALL_SITE __builtin_return_address(0)
+#endif
+#define FIXED_CHECK(type, op, value) FixedCheckRange<type>((value), FixedOp::op, FIXED_CALL_SITE)
+#define FIXED_CHECK_DIVISOR(type, divisor) FixedCheckDivisor((divisor), sizeof(type) * 8, FIXED_CALL_SITE)
+#else
+#define FIXED_OPERATOR
+#define FIXED_CHECK(type, op, value) (value)
+#define FIXED_CHECK_DIVISOR(type, divisor) (divisor)
+#endif
+
 #if 1
 struct fixed8_t
 {
@@ -45,27 +105,27 @@ struct fixed8_t
 		return fixed8_t(Raw(inRawValue));
 	}
 
-	fixed8_t operator -() const
+	FIXED_OPERATOR fixed8_t operator -() const
 	{
-		return FromRaw(-rawValue);
+		return FromRaw(FIXED_CHECK(int8_t, Negate, -rawValue));
 	}
 };
 
-constexpr fixed8_t operator+ (const fixed8_t& lhs, const fixed8_t& rhs)
+FIXED_OPERATOR constexpr fixed8_t operator+ (const fixed8_t& lhs, const fixed8_t& rhs)
 {
-	return fixed8_t::FromRaw(lhs.rawValue + rhs.rawValue);
+	return fixed8_t::FromRaw(FIXED_CHECK(int8_t, Add, lhs.rawValue + rhs.rawValue));
 }
-constexpr fixed8_t operator- (const fixed8_t& lhs, const fixed8_t& rhs)
+FIXED_OPERATOR constexpr fixed8_t operator- (const fixed8_t& lhs, const fixed8_t& rhs)
 {
-	return fixed8_t::FromRaw(lhs.rawValue - rhs.rawValue);
+	return fixed8_t::FromRaw(FIXED_CHECK(int8_t, Subtract, lhs.rawValue - rhs.rawValue));
 }
-constexpr fixed8_t operator* (const fixed8_t& lhs, const fixed8_t& rhs)
+FIXED_OPERATOR constexpr fixed8_t operator* (const fixed8_t& lhs, const fixed8_t& rhs)
 {
-	return fixed8_t::FromRaw(int8_t((int16_t(lhs.rawValue) * int16_t(rhs.rawValue)) >> FixedFractionalBits));
+	return fixed8_t::FromRaw(int8_t(FIXED_CHECK(int8_t, Multiply, (int16_t(lhs.rawValue) * int16_t(rhs.rawValue)) >> FixedFractionalBits)));
 }
-constexpr fixed8_t operator/ (const fixed8_t& lhs, const fixed8_t& rhs)
+FIXED_OPERATOR constexpr fixed8_t operator/ (const fixed8_t& lhs, const fixed8_t& rhs)
 {
-	return fixed8_t::FromRaw((int16_t(lhs.rawValue) << FixedFractionalBits) / rhs.rawValue);
+	return fixed8_t::FromRaw(FIXED_CHECK(int8_t, Divide, (int16_t(lhs.rawValue) << FixedFractionalBits) / FIXED_CHECK_DIVISOR(int8_t, rhs.rawValue)));
 }
 constexpr bool operator < (const fixed8_t& lhs, const fixed8_t& rhs)
 {
@@ -114,19 +174,19 @@ struct fixed16_t
 		return fixed16_t(Raw(inRawValue));
 	}
 
-	fixed16_t operator -() const
+	FIXED_OPERATOR fixed16_t operator -() const
 	{
-		return FromRaw(-rawValue);
+		return FromRaw(FIXED_CHECK(int16_t, Negate, -rawValue));
 	}
-	fixed16_t operator +=(const fixed16_t& other)
+	FIXED_OPERATOR fixed16_t operator +=(const fixed16_t& other)
 	{
-		rawValue += other.rawValue;
+		rawValue = FIXED_CHECK(int16_t, Add, rawValue + other.rawValue);
 		return *this;
 	}
 
-	explicit operator fixed8_t() const
+	FIXED_OPERATOR explicit operator fixed8_t() const
 	{
-		return fixed8_t::FromRaw((int8_t)rawValue);
+		return fixed8_t::FromRaw((int8_t)FIXED_CHECK(int8_t, Narrow, rawValue));
 	}
 
 	explicit operator int() const
@@ -135,33 +195,33 @@ struct fixed16_t
 	}
 };
 
-constexpr fixed16_t operator +(const fixed16_t& lhs, const fixed16_t& rhs) 
+FIXED_OPERATOR constexpr fixed16_t operator +(const fixed16_t& lhs, const fixed16_t& rhs) 
 {
-	return fixed16_t::FromRaw(lhs.rawValue + rhs.rawValue);
+	return fixed16_t::FromRaw(FIXED_CHECK(int16_t, Add, lhs.rawValue + rhs.rawValue));
 }
-constexpr fixed16_t operator -(const fixed16_t& lhs, const fixed16_t& rhs) 
+FIXED_OPERATOR constexpr fixed16_t operator -(const fixed16_t& lhs, const fixed16_t& rhs) 
 {
-	return fixed16_t::FromRaw(lhs.rawValue - rhs.rawValue);
+	return fixed16_t::FromRaw(FIXED_CHECK(int16_t, Subtract, lhs.rawValue - rhs.rawValue));
 }
-constexpr fixed16_t operator *(const fixed16_t& lhs, const fixed16_t& rhs) 
+FIXED_OPERATOR constexpr fixed16_t operator *(const fixed16_t& lhs, const fixed16_t& rhs) 
 {
-	return fixed16_t::FromRaw(int16_t((int32_t(lhs.rawValue) * (int32_t)rhs.rawValue) >> FixedFractionalBits));
+	return fixed16_t::FromRaw(int16_t(FIXED_CHECK(int16_t, Multiply, (int32_t(lhs.rawValue) * (int32_t)rhs.rawValue) >> FixedFractionalBits)));
 }
-constexpr fixed16_t operator *(const int lhs, const fixed16_t& rhs)
+FIXED_OPERATOR constexpr fixed16_t operator *(const int lhs, const fixed16_t& rhs)
 {
-	return fixed16_t::FromRaw(lhs * rhs.rawValue);
+	return fixed16_t::FromRaw(FIXED_CHECK(int16_t, Multiply, lhs * rhs.rawValue));
 }
-constexpr fixed16_t operator *(const fixed16_t& lhs, const int rhs)
+FIXED_OPERATOR constexpr fixed16_t operator *(const fixed16_t& lhs, const int rhs)
 {
-	return fixed16_t::FromRaw(lhs.rawValue * rhs);
+	return fixed16_t::FromRaw(FIXED_CHECK(int16_t, Multiply, lhs.rawValue * rhs));
 }
-constexpr fixed16_t operator /(const fixed16_t& lhs, const fixed16_t& rhs)
+FIXED_OPERATOR constexpr fixed16_t operator /(const fixed16_t& lhs, const fixed16_t& rhs)
 {
-	return fixed16_t::FromRaw((int32_t(lhs.rawValue) << FixedFractionalBits) / rhs.rawValue);
+	return fixed16_t::FromRaw(FIXED_CHECK(int16_t, Divide, (int32_t(lhs.rawValue) << FixedFractionalBits) / FIXED_CHECK_DIVISOR(int16_t, rhs.rawValue)));
 }
-constexpr fixed16_t operator /(const fixed16_t& lhs, const int rhs)
+FIXED_OPERATOR constexpr fixed16_t operator /(const fixed16_t& lhs, const int rhs)
 {
-	return fixed16_t::FromRaw(lhs.rawValue / rhs);
+	return fixed16_t::FromRaw(FIXED_CHECK(int16_t, Divide, lhs.rawValue / FIXED_CHECK_DIVISOR(int16_t, rhs)));
 }
 constexpr bool operator < (const fixed16_t& lhs, const fixed16_t& rhs)
 {
@@ -306,16 +366,18 @@ struct FixedMath
 		return fixed8_t::FromRaw(pgm_read_byte(&sinTable[FIXED_ANGLE_WRAP(FIXED_ANGLE_90 - angle)]));
 	}
 
-	static inline fixed16_t QuickDivide(fixed16_t x, fixed8_t denom)
+	FIXED_OPERATOR static inline fixed16_t QuickDivide(fixed16_t x, fixed8_t denom)
 	{
+		COUNT_OP(QuickDivide);
 		//return x / denom;
-		return fixed16_t::FromRaw((int16_t)(( (int32_t)(x.rawValue) * pgm_read_word(&recipTable[(uint8_t)denom.rawValue]) ) >> 4));
+		return fixed16_t::FromRaw((int16_t)FIXED_CHECK(int16_t, QuickDivide, ( (int32_t)(x.rawValue) * pgm_read_word(&recipTable[(uint8_t)denom.rawValue]) ) >> 4));
 	}
 };
 
 
 uint16_t Random();
 void SeedRandom(uint16_t seed);
+uint16_t GetRandomState();
 
 template <typename T>
 struct Vector3Base
@@ -4,6 +4,17 @@
 //#include "Draw.h"
 #include "FixedMath.h"
 #include "Platform.h"
+#include "Profiler.h"
+#include "MemoryStats.h"
+#include "Replay.h"
+
+#if REPLAY_PLAYBACK
+#include "ReplayData.h"
+
+uint8_t playbackInput;
+// Whether this tick's input came from the replay, which stops playing as its last input is read
+bool hasPlaybackInput;
+#endif
 
 Arduboy2Base arduboy;
 ArduboyTones sound(arduboy.audio.enabled);
@@ -11,6 +22,13 @@ Sprites sprites;
 
 uint8_t Platform::GetInput()
 {
+#if REPLAY_PLAYBACK
+  if(hasPlaybackInput)
+  {
+    return playbackInput;
+  }
+#endif
+
   uint8_t result = 0;
   
   if(arduboy.pressed(A_BUTTON))
@@ -141,6 +159,16 @@ void Platform::FillScreen(uint8_t colour)
 
 unsigned long lastTimingSample;
 
+#if MEMORY_STATS
+// Frames between SRAM usage reports over serial
+constexpr uint8_t memoryReportInterval = TARGET_FRAMERATE;
+
+void WriteSerial(char c)
+{
+  Serial.write(c);
+}
+#endif
+
 bool Platform::IsAudioEnabled()
 {
 	return arduboy.audio.enabled();
@@ -171,9 +199,16 @@ void setup()
   //arduboy.audio.off();
   
   //Serial.begin(9600);
+#if MEMORY_STATS
+  Serial.begin(9600);
+#endif
 
 //  SeedRandom((uint16_t) arduboy.generateRandomSeed());
   Game::Init();
+
+#if REPLAY_PLAYBACK
+  Replay::BeginPlayback(replayData);
+#endif
   
   lastTimingSample = millis();
 }
@@ -191,7 +226,22 @@ void loop()
   if(arduboy.nextFrame())
 #endif
   {
+#if PROFILER
+	Profiler::BeginFrame();
+#endif
+
 	constexpr int16_t frameDuration = 1000 / TARGET_FRAMERATE;
+#if REPLAY_PLAYBACK
+	// One tick per frame so that the draws line up with the host
+	hasPlaybackInput = Replay::IsPlaying();
+	if(hasPlaybackInput)
+	{
+		playbackInput = Replay::NextInput();
+		Game::Tick();
+		tickAccum = 0;
+	}
+	else
+#endif
 	while(tickAccum > frameDuration)
 	{
 		Game::Tick();
@@ -203,6 +253,10 @@ void loop()
     //Serial.write(arduboy.getBuffer(), 128 * 64 / 8);
 
 #if DEV_MODE
+	// Per stage timings, drawn as a stacked bar above the CPU load bar
+	Profiler::EndFrame();
+	Profiler::DrawOverlay();
+
 	// CPU load bar graph	
 	int load = arduboy.cpuLoad();
 	uint8_t* screenPtr = arduboy.getBuffer();
@@ -213,6 +267,15 @@ void loop()
 	}
 	screenPtr[100] = 0;
 #endif
+
+#if MEMORY_STATS
+	static uint8_t memoryReportCounter = 0;
+	if(++memoryReportCounter == memoryReportInterval)
+	{
+		MemoryStats::Report(WriteSerial);
+		memoryReportCounter = 0;
+	}
+#endif
 	
     arduboy.display(false);
   }
@@ -5,7 +5,7 @@
 #include "Defines.h"
 #include "Font.h"
 #include "Platform.h"
-#include "Generated/SpriteTypes.h"
+#include "Generated/SpriteData.inc.h"
 
 // Font Definition
 const uint8_t font4x6[96][2] PROGMEM = {
@@ -384,7 +384,7 @@ void Font::PrintInt(uint16_t val, uint8_t line, uint8_t x, uint8_t colour)
 void Font::DrawChar(uint8_t* screenPtr, char c, uint8_t xorMask)
 {
 	const uint8_t index = ((unsigned char)(c)) - firstGlyphIndex;
-	const uint8_t* fontPtr = 0;// fontPageData + glyphWidth * index;
+	const uint8_t* fontPtr = fontPageData + glyphWidth * index;
 
 	screenPtr[0] = xorMask ^ pgm_read_byte(&fontPtr[0]);
 	screenPtr[1] = xorMask ^ pgm_read_byte(&fontPtr[1]);
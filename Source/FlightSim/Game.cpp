@@ -2,6 +2,8 @@
 #include "Game.h"
 #include "Platform.h"
 #include "FixedMath.h"
+#include "Profiler.h"
+#include "Dither.h"
 #include <math.h>
 #include <stdlib.h>
 //#include <stdio.h>
@@ -17,16 +19,18 @@ struct ScreenPoint
 	fixed16_t z;
 };
 
-struct Camera
-{
-	Vector3s position;
-	Matrix3x3 rotation;
-	Matrix3x3 invRotation;
-	angle_t pitch, roll, yaw;
-};
-
 Camera camera;
 
+#if INTERP_TUNING
+InterpSettings interpSettings = defaultInterpSettings;
+#endif
+
+void Camera::UpdateRotation()
+{
+	rotation = Matrix3x3::RotateZ(roll) * Matrix3x3::RotateX(-pitch) * Matrix3x3::RotateY(-yaw);
+	invRotation = rotation.Transpose();
+}
+
 void Game::Init()
 {
 	camera.rotation = Matrix3x3::Identity();
@@ -71,184 +75,158 @@ Vector3s WorldToView(const Vector3s& inPoint)
 	return camera.invRotation * worldPosition;
 }
 
-const uint8_t ditherPattern1[] =
-{
-	1, 3,
-	4, 2
-};
-const uint8_t ditherPattern2[] =
+template<int textureSize>
+uint8_t ReadTextureFromWorldSpace(const uint8_t* texPtr, const fixed16_t worldX, const fixed16_t worldZ)
 {
-	4, 2,
-	1, 3,
-};
+	// Convert to texture space
+	uint8_t u = ((int)(worldX) >> 4) & (textureSize - 1);
+	uint8_t v = ((int)(worldZ) >> 4) & (textureSize - 1);
 
-inline Vector3b Lerp(const Vector3b& a, const Vector3b& b, fixed8_t alpha)
-{
-	const fixed8_t oneMinusAlpha = fixed8_t::FromRaw(64 - alpha.rawValue);
-	return Vector3b(
-		fixed8_t::FromRaw((a.x.rawValue * oneMinusAlpha.rawValue + b.x.rawValue * alpha.rawValue) >> FixedFractionalBits),
-		fixed8_t::FromRaw((a.y.rawValue * oneMinusAlpha.rawValue + b.y.rawValue * alpha.rawValue) >> FixedFractionalBits),
-		fixed8_t::FromRaw((a.z.rawValue * oneMinusAlpha.rawValue + b.z.rawValue * alpha.rawValue) >> FixedFractionalBits));
+	int index = v * textureSize + u;
+	return pgm_read_byte(&texPtr[index]);
 }
 
-struct DitherWriter
+// Ground intersection for the 2x2 block at screen row y of a column
+struct GroundSample
 {
-	DitherWriter(uint8_t* inBufferPtr, const uint8_t* inDitherPattern, uint8_t inMaxWrites) :
-		bufferPtr(inBufferPtr),
-		ditherPattern(inDitherPattern),
-		writesLeft(inMaxWrites),
-		buffer1(0),
-		buffer2(0),
-		bufferPos(0),
-		writeMask(1)
-	{
-	}
+	fixed16_t x, z;
+	uint8_t depth;				// -view direction y, which is inversely proportional to distance, 0 if off the ground
+	uint8_t runShift;			// the run ending here is 1 << runShift blocks long
+};
 
-	bool CanWrite()
+inline GroundSample SampleGround(const Vector3b& viewDirTop, const Vector3b& viewDirBottom, uint8_t y, uint8_t runShift)
+{
+	GroundSample result;
+	Vector3b worldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(y));
+	fixed16_t distance = 0;
+	result.depth = 0;
+	if (worldDir.y < 0)
 	{
-		return writesLeft > 0;
+		distance = FixedMath::QuickDivide(fixed16_t(camera.position.y), -worldDir.y);
+		result.depth = (uint8_t)-worldDir.y.rawValue;
 	}
+	result.x = camera.position.x + worldDir.x * distance;
+	result.z = camera.position.z + worldDir.z * distance;
+	result.runShift = runShift;
+	return result;
+}
 
-	inline void Write(uint8_t outColour)
-	{
-		// Fill in 2x2 pixels based on dither pattern
-		if (outColour >= ditherPattern[0])
-		{
-			buffer1 |= writeMask;
-		}
-		if (outColour >= ditherPattern[1])
-		{
-			buffer2 |= writeMask;
-		}
-		writeMask <<= 1;
-		if (outColour >= ditherPattern[2])
-		{
-			buffer1 |= writeMask;
-		}
-		if (outColour >= ditherPattern[3])
-		{
-			buffer2 |= writeMask;
-		}
-		writeMask <<= 1;
-
-		bufferPos++;
-		if (bufferPos == 4)
-		{
-			// Write out buffer and move on to the next 8 pixels
-			bufferPtr[0] = buffer1;
-			bufferPtr[1] = buffer2;
-			bufferPtr += DISPLAY_WIDTH;
-			writeMask = 1;
-			bufferPos = 0;
-			buffer1 = 0;
-			buffer2 = 0;
-		}
+// Whether stepping affinely from a to b stays within maxError world units (raw) of perspective
+// correct. The error peaks halfway, where it is |b - a| * |dist b - dist a| / 2 (dist a + dist b).
+// Distance is inversely proportional to depth, so the distance ratio is the depth ratio flipped,
+// which can't wrap like fixed16_t distances far out.
+inline bool AffineRunFits(const GroundSample& a, const GroundSample& b, uint16_t maxError)
+{
+	COUNT_OP(SpanErrorTest);
 
-		writesLeft--;
-	}
+	if (!a.depth || !b.depth)
+		return false;
 
-	uint8_t* bufferPtr;
-	const uint8_t* ditherPattern;
-	uint8_t writesLeft;
-	uint8_t buffer1, buffer2, bufferPos, writeMask;
-};
+	// Past 512 world units the distance wraps and the texture is noise anyway, so take the cheapest run
+	uint8_t farDepth = (uint16_t)camera.position.y.rawValue >> 9;
+	if (a.depth <= farDepth && b.depth <= farDepth)
+		return true;
 
-template<int textureSize>
-uint8_t ReadTextureFromWorldSpace(const uint8_t* texPtr, const fixed16_t worldX, const fixed16_t worldZ)
-{
-	// Convert to texture space
-	uint8_t u = ((int)(worldX) >> 4) & (textureSize - 1);
-	uint8_t v = ((int)(worldZ) >> 4) & (textureSize - 1);
+	int16_t deltaX = (b.x - a.x).rawValue;
+	int16_t deltaZ = (b.z - a.z).rawValue;
+	uint16_t absDeltaX = deltaX < 0 ? -(uint16_t)deltaX : (uint16_t)deltaX;
+	uint16_t absDeltaZ = deltaZ < 0 ? -(uint16_t)deltaZ : (uint16_t)deltaZ;
+	uint16_t delta = absDeltaX > absDeltaZ ? absDeltaX : absDeltaZ;
+	uint8_t deltaDepth = a.depth > b.depth ? a.depth - b.depth : b.depth - a.depth;
 
-	int index = v * textureSize + u;
-	return pgm_read_byte(&texPtr[index]);
+	return (uint32_t)delta * deltaDepth <= (uint32_t)maxError * 2 * (uint16_t)(a.depth + b.depth);
 }
 
+// Draws ground down a column in affine runs of 1 to 16 blocks, splitting each run in half until
+// its estimated perspective error is within interpSettings.maxTexelError. Every split costs a
+// divide, so a span splits at most interpSettings.maxSpanSplits times to bound the worst frame.
 inline void DrawGroundSpan(DitherWriter& ditherWriter, const Vector3b& viewDirTop, const Vector3b& viewDirBottom, uint8_t& outY, uint8_t height)
 {
+	PROFILE_SCOPE(GroundSpan);
+
+	constexpr uint8_t maxRunShift = 4;
+	const uint16_t maxError = interpSettings.maxTexelError.rawValue * 16;		// texels are 16 world units
 	uint8_t steps = height >> 1;
-	Vector3b lastWorldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(outY));
-	fixed16_t lastDistance = FixedMath::QuickDivide(fixed16_t(camera.position.y), -lastWorldDir.y);
-	fixed16_t lastIntersectionX = camera.position.x + lastWorldDir.x * lastDistance;
-	fixed16_t lastIntersectionZ = camera.position.z + lastWorldDir.z * lastDistance;
-	fixed8_t interpThreshold = fixed8_t::FromRaw(-6);
+	uint8_t splitsLeft = interpSettings.maxSpanSplits;
+
+	// Ends of the runs still to draw, nearest on top. A split run's halfway sample is pushed
+	// so every divide ends up as the end of a drawn run.
+	GroundSample ends[maxRunShift + 1];
+	uint8_t numEnds = 0;
+	GroundSample start = SampleGround(viewDirTop, viewDirBottom, outY, 0);
 
 	while (steps > 0)
 	{
-		if (steps >= 4 && lastWorldDir.y < interpThreshold)
+		if (numEnds == 0)
 		{
-			outY += 8;
-			steps -= 4;
-
-			Vector3b nextWorldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(outY));
-			fixed16_t nextDistance = FixedMath::QuickDivide(fixed16_t(camera.position.y), -nextWorldDir.y);
-			fixed16_t nextIntersectionX = camera.position.x + nextWorldDir.x * nextDistance;
-			fixed16_t nextIntersectionZ = camera.position.z + nextWorldDir.z * nextDistance;
-			fixed16_t deltaX = fixed16_t::FromRaw((nextIntersectionX - lastIntersectionX).rawValue >> 2);
-			fixed16_t deltaZ = fixed16_t::FromRaw((nextIntersectionZ - lastIntersectionZ).rawValue >> 2);
-
-			ditherWriter.Write(ReadTextureFromWorldSpace<64>(mapTexture, lastIntersectionX, lastIntersectionZ));
-			lastIntersectionX += deltaX;	lastIntersectionZ += deltaZ;
-			ditherWriter.Write(ReadTextureFromWorldSpace<64>(mapTexture, lastIntersectionX, lastIntersectionZ));
-			lastIntersectionX += deltaX;	lastIntersectionZ += deltaZ;
-			ditherWriter.Write(ReadTextureFromWorldSpace<64>(mapTexture, lastIntersectionX, lastIntersectionZ));
-			lastIntersectionX += deltaX;	lastIntersectionZ += deltaZ;
-			ditherWriter.Write(ReadTextureFromWorldSpace<64>(mapTexture, lastIntersectionX, lastIntersectionZ));
-
-			lastIntersectionX = nextIntersectionX;
-			lastIntersectionZ = nextIntersectionZ;
-			lastWorldDir = nextWorldDir;
+			uint8_t runShift = maxRunShift;
+			while ((1 << runShift) > steps)
+				runShift--;
+			ends[numEnds++] = SampleGround(viewDirTop, viewDirBottom, outY + (2 << runShift), runShift);
 		}
-		else
+
+		GroundSample& end = ends[numEnds - 1];
+		if (end.runShift > 0 && splitsLeft > 0 && !AffineRunFits(start, end, maxError))
 		{
-			ditherWriter.Write(ReadTextureFromWorldSpace<64>(mapTexture, lastIntersectionX, lastIntersectionZ));
-			//ditherWriter.Write(0);
+			// Both halves are half as long
+			splitsLeft--;
+			uint8_t runShift = --end.runShift;
+			ends[numEnds++] = SampleGround(viewDirTop, viewDirBottom, outY + (2 << runShift), runShift);
+			continue;
+		}
+		uint8_t runSteps = 1 << end.runShift;
+		fixed16_t intersectionX = start.x;
+		fixed16_t intersectionZ = start.z;
+		fixed16_t deltaX = fixed16_t::FromRaw((end.x - start.x).rawValue >> end.runShift);
+		fixed16_t deltaZ = fixed16_t::FromRaw((end.z - start.z).rawValue >> end.runShift);
 
-			outY += 2;
-			steps--;
-			if (steps > 0)
-			{
-				lastWorldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(outY));
-				lastDistance = FixedMath::QuickDivide(fixed16_t(camera.position.y), -lastWorldDir.y);
-				lastIntersectionX = camera.position.x + lastWorldDir.x * lastDistance;
-				lastIntersectionZ = camera.position.z + lastWorldDir.z * lastDistance;
-			}
+		for (uint8_t n = 0; n < runSteps; n++)
+		{
+			ditherWriter.Write(ReadTextureFromWorldSpace<64>(mapTexture, intersectionX, intersectionZ));
+			intersectionX += deltaX;	intersectionZ += deltaZ;
 		}
+
+		outY += runSteps * 2;
+		steps -= runSteps;
+		start = end;
+		numEnds--;
 	}
 }
 
 inline void DrawCloudSpan(DitherWriter& ditherWriter, const Vector3b& viewDirTop, const Vector3b& viewDirBottom, uint8_t& outY, uint8_t height)
 {
+	PROFILE_SCOPE(CloudSpan);
+
 	constexpr fixed16_t cloudHeight = 128;
 	fixed16_t planeDistance = cloudHeight - camera.position.y;
 	uint8_t steps = height >> 1;
+	const uint8_t blockShift = interpSettings.blockShift;
+	const uint8_t blockSteps = 1 << blockShift;
 
-	if (steps >= 4)
+	if (steps >= blockSteps)
 	{
 		Vector3b lastWorldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(outY));
 		fixed16_t lastDistance = FixedMath::QuickDivide(planeDistance, lastWorldDir.y);
 		fixed16_t lastIntersectionX = camera.position.x + lastWorldDir.x * lastDistance;
 		fixed16_t lastIntersectionZ = camera.position.z + lastWorldDir.z * lastDistance;
 
-		while (steps >= 4)
+		while (steps >= blockSteps)
 		{
-			outY += 8;
-			steps -= 4;
+			outY += blockSteps * 2;
+			steps -= blockSteps;
 
 			Vector3b nextWorldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(outY));
 			fixed16_t nextDistance = FixedMath::QuickDivide(planeDistance, nextWorldDir.y);
 			fixed16_t nextIntersectionX = camera.position.x + nextWorldDir.x * nextDistance;
 			fixed16_t nextIntersectionZ = camera.position.z + nextWorldDir.z * nextDistance;
-			fixed16_t deltaX = fixed16_t::FromRaw((nextIntersectionX - lastIntersectionX).rawValue >> 2);
-			fixed16_t deltaZ = fixed16_t::FromRaw((nextIntersectionZ - lastIntersectionZ).rawValue >> 2);
+			fixed16_t deltaX = fixed16_t::FromRaw((nextIntersectionX - lastIntersectionX).rawValue >> blockShift);
+			fixed16_t deltaZ = fixed16_t::FromRaw((nextIntersectionZ - lastIntersectionZ).rawValue >> blockShift);
 
-			ditherWriter.Write(ReadTextureFromWorldSpace<32>(cloudTexture, lastIntersectionX, lastIntersectionZ));
-			lastIntersectionX += deltaX;	lastIntersectionZ += deltaZ;
-			ditherWriter.Write(ReadTextureFromWorldSpace<32>(cloudTexture, lastIntersectionX, lastIntersectionZ));
-			lastIntersectionX += deltaX;	lastIntersectionZ += deltaZ;
-			ditherWriter.Write(ReadTextureFromWorldSpace<32>(cloudTexture, lastIntersectionX, lastIntersectionZ));
-			lastIntersectionX += deltaX;	lastIntersectionZ += deltaZ;
-			ditherWriter.Write(ReadTextureFromWorldSpace<32>(cloudTexture, lastIntersectionX, lastIntersectionZ));
+			for (uint8_t n = 0; n < blockSteps; n++)
+			{
+				ditherWriter.Write(ReadTextureFromWorldSpace<32>(cloudTexture, lastIntersectionX, lastIntersectionZ));
+				lastIntersectionX += deltaX;	lastIntersectionZ += deltaZ;
+			}
 
 			lastIntersectionX = nextIntersectionX;
 			lastIntersectionZ = nextIntersectionZ;
@@ -268,21 +246,208 @@ inline void DrawCloudSpan(DitherWriter& ditherWriter, const Vector3b& viewDirTop
 }
 
 
-void GameDrawInterp()
+// Screen row where view direction y crosses a threshold, stepped across the columns.
+// View y is linear both down a column and across the viewport, so the crossing is a line.
+struct BoundaryLine
+{
+	// viewDiffSum is the top minus bottom view y of the left and right edges added together
+	void Init(fixed8_t threshold, fixed8_t topLeftY, fixed8_t topRightY, int16_t viewDiffSum)
+	{
+		int16_t leftOffset = topLeftY.rawValue - threshold.rawValue;
+		int16_t rightOffset = topRightY.rawValue - topLeftY.rawValue;
+
+		// 64 rows per unit of view y difference, halved as viewDiffSum holds two differences
+		if (viewDiffSum != 0)
+		{
+			row = ((int32_t)leftOffset * 32768) / viewDiffSum;
+			step = ((int32_t)rightOffset * 512) / viewDiffSum;
+		}
+		else
+		{
+			// 90 degrees sideways: columns are entirely above or below, treat the difference as tiny
+			row = (int32_t)leftOffset * 0x200000;
+			step = (int32_t)rightOffset * 32768;
+		}
+	}
+
+	uint8_t GetRow(uint8_t displayHeight) const
+	{
+		if (row <= 0)
+			return 0;
+		if (row >= ((int32_t)displayHeight << 8))
+			return displayHeight;
+		return (uint8_t)(row >> 8);
+	}
+
+	int32_t row;		// 8 fractional bits
+	int32_t step;		// per 2 pixel column
+};
+
+// Corner of an 8x8 pixel cell for GameDrawGrid
+struct GridNode
+{
+	fixed16_t x, z;		// where the view direction meets the ground or cloud plane
+	fixed8_t y;			// view direction y, which decides the plane
+};
+
+constexpr uint8_t gridCellShift = 2;						// cells are 1 << gridCellShift 2x2 pixel blocks across
+constexpr uint8_t gridRows = ((DISPLAY_HEIGHT - 16) >> (gridCellShift + 1)) + 1;
+
+// Exact intersections down the column of nodes at viewport block column blockX
+void ComputeGridNodes(GridNode* nodes, const Vector3b& topLeftViewDir, const Vector3b& topRightViewDir,
+	const Vector3b& bottomLeftViewDir, const Vector3b& bottomRightViewDir, uint8_t blockX)
 {
-	constexpr fixed16_t groundHeight = 0;
 	constexpr fixed16_t cloudHeight = 128;
-	constexpr int maxDrawDistance = 2000;
+	const fixed8_t interpThreshold = interpSettings.interpThreshold;
+	const fixed8_t cloudThreshold = interpSettings.cloudThreshold;
+
+	fixed8_t viewXAlpha = fixed8_t::FromRaw(blockX);
+	Vector3b viewDirTop = Lerp(topLeftViewDir, topRightViewDir, viewXAlpha);
+	Vector3b viewDirBottom = Lerp(bottomLeftViewDir, bottomRightViewDir, viewXAlpha);
+
+	for (uint8_t row = 0; row < gridRows; row++)
+	{
+		Vector3b worldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(row << (gridCellShift + 1)));
+		nodes[row].y = worldDir.y;
+
+		// Nodes too close to the horizon are never interpolated, so skip the divide
+		fixed16_t distance;
+		if (worldDir.y < interpThreshold)
+		{
+			distance = FixedMath::QuickDivide(fixed16_t(camera.position.y), -worldDir.y);
+		}
+		else if (worldDir.y > cloudThreshold)
+		{
+			distance = FixedMath::QuickDivide(cloudHeight - camera.position.y, worldDir.y);
+		}
+		else
+		{
+			continue;
+		}
+		nodes[row].x = camera.position.x + worldDir.x * distance;
+		nodes[row].z = camera.position.z + worldDir.z * distance;
+	}
+}
+
+inline void IntersectGridPlane(const Vector3b& worldDir, fixed16_t planeDistance, bool cloud, fixed16_t& outX, fixed16_t& outZ)
+{
+	fixed16_t distance = FixedMath::QuickDivide(planeDistance, cloud ? worldDir.y : -worldDir.y);
+	outX = camera.position.x + worldDir.x * distance;
+	outZ = camera.position.z + worldDir.z * distance;
+}
+
+// Draws ground or cloud texture down a column, interpolating texture coordinates bilinearly
+// between the grid nodes either side. Cells with a corner near the horizon or on the other
+// plane fall back to affine runs down the column, then to an exact intersection for every
+// 2x2 block where the column itself reaches the horizon.
+template<int textureSize>
+void DrawGridSpan(DitherWriter& ditherWriter, const uint8_t* texture, bool cloud, const GridNode* left, const GridNode* right,
+	uint8_t column, const Vector3b& viewDirTop, const Vector3b& viewDirBottom, uint8_t& outY, uint8_t height)
+{
+	constexpr fixed16_t cloudHeight = 128;
+	const fixed8_t interpThreshold = interpSettings.interpThreshold;
+	const fixed8_t cloudThreshold = interpSettings.cloudThreshold;
+	constexpr uint8_t cellMask = (1 << gridCellShift) - 1;
+	uint8_t steps = height >> 1;
+
+	while (steps > 0)
+	{
+		uint8_t blockY = outY >> 1;
+		uint8_t row = blockY >> gridCellShift;
+		uint8_t cellSteps = (1 << gridCellShift) - (blockY & cellMask);
+		if (cellSteps > steps)
+			cellSteps = steps;
+		steps -= cellSteps;
+
+		bool interpolate = cloud ?
+			left[row].y > cloudThreshold && right[row].y > cloudThreshold && left[row + 1].y > cloudThreshold && right[row + 1].y > cloudThreshold :
+			left[row].y < interpThreshold && right[row].y < interpThreshold && left[row + 1].y < interpThreshold && right[row + 1].y < interpThreshold;
+
+		if (interpolate)
+		{
+			fixed16_t topX = left[row].x + fixed16_t::FromRaw(((right[row].x - left[row].x).rawValue >> gridCellShift) * column);
+			fixed16_t topZ = left[row].z + fixed16_t::FromRaw(((right[row].z - left[row].z).rawValue >> gridCellShift) * column);
+			fixed16_t bottomX = left[row + 1].x + fixed16_t::FromRaw(((right[row + 1].x - left[row + 1].x).rawValue >> gridCellShift) * column);
+			fixed16_t bottomZ = left[row + 1].z + fixed16_t::FromRaw(((right[row + 1].z - left[row + 1].z).rawValue >> gridCellShift) * column);
+			fixed16_t deltaX = fixed16_t::FromRaw((bottomX - topX).rawValue >> gridCellShift);
+			fixed16_t deltaZ = fixed16_t::FromRaw((bottomZ - topZ).rawValue >> gridCellShift);
+			fixed16_t intersectionX = topX + fixed16_t::FromRaw(deltaX.rawValue * (blockY & cellMask));
+			fixed16_t intersectionZ = topZ + fixed16_t::FromRaw(deltaZ.rawValue * (blockY & cellMask));
+
+			while (cellSteps > 0)
+			{
+				ditherWriter.Write(ReadTextureFromWorldSpace<textureSize>(texture, intersectionX, intersectionZ));
+				intersectionX += deltaX;	intersectionZ += deltaZ;
+				outY += 2;
+				cellSteps--;
+			}
+		}
+		else
+		{
+			fixed16_t planeDistance = cloud ? cloudHeight - camera.position.y : fixed16_t(camera.position.y);
+			Vector3b worldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(outY));
+			fixed16_t intersectionX, intersectionZ;
+			IntersectGridPlane(worldDir, planeDistance, cloud, intersectionX, intersectionZ);
+
+			// Finer blocks one column wide if both ends of this column's run are clear of the horizon
+			bool exact = true;
+			fixed16_t deltaX = 0, deltaZ = 0;
+			if (cellSteps == (1 << gridCellShift) && (cloud ? worldDir.y > cloudThreshold : worldDir.y < interpThreshold))
+			{
+				Vector3b endDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(outY + (cellSteps << 1)));
+				if (cloud ? endDir.y > cloudThreshold : endDir.y < interpThreshold)
+				{
+					fixed16_t endX, endZ;
+					IntersectGridPlane(endDir, planeDistance, cloud, endX, endZ);
+					deltaX = fixed16_t::FromRaw((endX - intersectionX).rawValue >> gridCellShift);
+					deltaZ = fixed16_t::FromRaw((endZ - intersectionZ).rawValue >> gridCellShift);
+					exact = false;
+				}
+			}
+
+			while (cellSteps > 0)
+			{
+				ditherWriter.Write(ReadTextureFromWorldSpace<textureSize>(texture, intersectionX, intersectionZ));
+				outY += 2;
+				cellSteps--;
+
+				if (!exact)
+				{
+					intersectionX += deltaX;	intersectionZ += deltaZ;
+				}
+				else if (cellSteps > 0)
+				{
+					worldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(outY));
+					IntersectGridPlane(worldDir, planeDistance, cloud, intersectionX, intersectionZ);
+				}
+			}
+		}
+	}
+}
+
+enum class InterpRegion : uint8_t
+{
+	Cloud,
+	Sky,
+	DistantGround,
+	Ground
+};
+
+// Column renderer shared by GameDrawInterp and GameDrawGrid, which only differ in how texture
+// coordinates are found inside the ground and cloud spans
+template<bool useGrid>
+void DrawInterpColumns()
+{
 	constexpr int skyColour = 3;
 	constexpr int groundColour = 2;
 	constexpr fixed8_t half = fixed8_t::FromRaw(1 << (FixedFractionalBits - 1));
+	constexpr uint8_t numBoundaries = 3;
 
-	constexpr fixed8_t groundThreshold = fixed8_t::FromRaw(-3);		// below this is ground texture
-	constexpr fixed8_t cloudThreshold = fixed8_t::FromRaw(8);		// above this is cloud texture
+	const fixed8_t groundThreshold = interpSettings.groundThreshold;		// below this is ground texture
+	const fixed8_t cloudThreshold = interpSettings.cloudThreshold;		// above this is cloud texture
 
 	// Rotate view a bit because bottom area is obscured
-	angle_t cameraTilt = 4;
-	Matrix3x3 cameraRotation = Matrix3x3::RotateX(cameraTilt) * camera.rotation;
+	Matrix3x3 cameraRotation = Matrix3x3::RotateX(interpSettings.cameraTilt) * camera.rotation;
 
 	// Calculate world view direction for each corner of the viewport
 	Vector3b topLeftViewDir = cameraRotation * Vector3b(-1, half, 1);
@@ -290,8 +455,41 @@ void GameDrawInterp()
 	Vector3b bottomLeftViewDir = cameraRotation * Vector3b(-1, -half, 1);
 	Vector3b bottomRightViewDir = cameraRotation * Vector3b(1, -half, 1);
 
+	// Regions in the order they appear down each column, with the boundaries between them.
+	// Upside down reverses the order, which is the same for every column.
+	int16_t viewDiffSum = (topLeftViewDir.y - bottomLeftViewDir.y).rawValue + (topRightViewDir.y - bottomRightViewDir.y).rawValue;
+	bool upsideDown = viewDiffSum < 0;
+	const fixed8_t thresholds[numBoundaries] = { cloudThreshold, 0, groundThreshold };
+	const InterpRegion regions[numBoundaries + 1] = { InterpRegion::Cloud, InterpRegion::Sky, InterpRegion::DistantGround, InterpRegion::Ground };
+
+	BoundaryLine boundaries[numBoundaries];
+	for (uint8_t n = 0; n < numBoundaries; n++)
+	{
+		boundaries[n].Init(thresholds[upsideDown ? numBoundaries - 1 - n : n], topLeftViewDir.y, topRightViewDir.y, viewDiffSum);
+	}
+
+	// Node columns either side of the current grid cell
+	GridNode gridNodes[2][useGrid ? gridRows : 1];
+	GridNode* leftNodes = gridNodes[0];
+	GridNode* rightNodes = gridNodes[1];
+	if (useGrid)
+	{
+		ComputeGridNodes(rightNodes, topLeftViewDir, topRightViewDir, bottomLeftViewDir, bottomRightViewDir, 0);
+	}
+
 	for (uint8_t x = 0; x < DISPLAY_WIDTH; x += 2)
 	{
+		COUNT_AT(x, 0);
+
+		uint8_t gridColumn = (x >> 1) & ((1 << gridCellShift) - 1);
+		if (useGrid && gridColumn == 0)
+		{
+			GridNode* swap = leftNodes;
+			leftNodes = rightNodes;
+			rightNodes = swap;
+			ComputeGridNodes(rightNodes, topLeftViewDir, topRightViewDir, bottomLeftViewDir, bottomRightViewDir, (x >> 1) + (1 << gridCellShift));
+		}
+
 		// Interpolate view directions for this column 
 		fixed8_t viewXAlpha = fixed8_t::FromRaw(x >> 1);
 		Vector3b viewDirTop = Lerp(topLeftViewDir, topRightViewDir, viewXAlpha);
@@ -303,160 +501,219 @@ void GameDrawInterp()
 
 		uint8_t outY = 0;
 
-		if (viewDirTop.y > viewDirBottom.y)
+		for (uint8_t n = 0; n <= numBoundaries; n++)
 		{
-			// Right side up
-			fixed8_t viewDiff = (viewDirTop.y - viewDirBottom.y);
+			uint8_t limit = displayHeight;
+			if (n < numBoundaries)
+			{
+				limit = boundaries[n].GetRow(displayHeight);
+				boundaries[n].row += boundaries[n].step;
+			}
 
-			if (viewDirTop.y > cloudThreshold)
+			if (limit <= outY)
+				continue;
+
+			switch (regions[upsideDown ? numBoundaries - n : n])
 			{
-				// Draw cloud span
-				int16_t limit = displayHeight;
-				
-				if (viewDirBottom.y < cloudThreshold)
+			case InterpRegion::Cloud:
+				if (useGrid)
 				{
-					int16_t cloudY = FixedMath::QuickDivide((viewDirTop.y - cloudThreshold), viewDiff).rawValue;
-					if (cloudY < limit)
-						limit = cloudY;
+					// DrawGridSpan draws both planes, so the zone is opened here
+					PROFILE_SCOPE(CloudSpan);
+					DrawGridSpan<32>(ditherWriter, cloudTexture, true, leftNodes, rightNodes, gridColumn, viewDirTop, viewDirBottom, outY, limit - outY);
 				}
-
-				DrawCloudSpan(ditherWriter, viewDirTop, viewDirBottom, outY, limit - outY);
-			}
-			if (ditherWriter.CanWrite() && viewDirTop.y > 0)
+				else
+					DrawCloudSpan(ditherWriter, viewDirTop, viewDirBottom, outY, limit - outY);
+				break;
+			case InterpRegion::Sky:
 			{
 				// Draw distant sky span
-				int16_t limit = displayHeight;
-
-				if (viewDirBottom.y < 0)
-				{
-					int16_t horizon = FixedMath::QuickDivide(viewDirTop.y - 0, viewDiff).rawValue;
-					if (horizon < limit)
-						limit = horizon;
-				}
-
-				while (outY < limit) // && ditherWriter.CanWrite())
+				PROFILE_SCOPE(SkyFill);
+				while (outY < limit)
 				{
 					ditherWriter.Write(skyColour);
 					outY += 2;
 				}
+				break;
 			}
-			if (ditherWriter.CanWrite() && viewDirTop.y > groundThreshold)
+			case InterpRegion::DistantGround:
 			{
-				// Draw distance ground span
-				int16_t limit = displayHeight;
-
-				if (viewDirBottom.y < 0)
-				{
-					int16_t groundY = FixedMath::QuickDivide((viewDirTop.y - groundThreshold), viewDiff).rawValue;
-					if (groundY < limit)
-						limit = groundY;
-				}
-
+				// Draw distant ground span
+				PROFILE_SCOPE(DistantGround);
 				while (outY < limit)
 				{
 					ditherWriter.Write(groundColour);
 					outY += 2;
 				}
+				break;
 			}
-			if (ditherWriter.CanWrite())
-			{
-				// Ground plane
-				DrawGroundSpan(ditherWriter, viewDirTop, viewDirBottom, outY, displayHeight - outY);
+			case InterpRegion::Ground:
+				if (useGrid)
+				{
+					PROFILE_SCOPE(GroundSpan);
+					DrawGridSpan<64>(ditherWriter, mapTexture, false, leftNodes, rightNodes, gridColumn, viewDirTop, viewDirBottom, outY, limit - outY);
+				}
+				else
+					DrawGroundSpan(ditherWriter, viewDirTop, viewDirBottom, outY, limit - outY);
+				break;
 			}
 		}
-		else if (viewDirTop.y < viewDirBottom.y)
-		{
-			// Upside down
-			fixed8_t viewDiff = (viewDirBottom.y - viewDirTop.y);
+	}
+}
 
-			if (viewDirTop.y < groundThreshold)
-			{
-				// Draw ground span
-				int16_t limit = displayHeight;
+void GameDrawInterp()
+{
+	DrawInterpColumns<false>();
+}
 
-				if (viewDirBottom.y > groundThreshold)
-				{
-					int16_t groundY = FixedMath::QuickDivide((groundThreshold - viewDirTop.y), viewDiff).rawValue;
-					if (groundY < limit)
-						limit = groundY;
-				}
+// GameDrawInterp with texture coordinates found exactly at the corners of 8x8 pixel cells and
+// interpolated bilinearly inside them, so the divides are shared across columns as well as rows
+void GameDrawGrid()
+{
+	DrawInterpColumns<true>();
+}
 
-				DrawGroundSpan(ditherWriter, viewDirTop, viewDirBottom, outY, limit - outY);
-			}
-			if (ditherWriter.CanWrite() && viewDirTop.y < 0)
-			{
-				// Draw distance ground span
-				int16_t limit = displayHeight;
 
-				if (viewDirBottom.y > 0)
-				{
-					int16_t horizon = FixedMath::QuickDivide((0 - viewDirTop.y), viewDiff).rawValue;
-					if (horizon < limit)
-						limit = horizon;
-				}
+// Same view and regions as GameDrawInterp, but the ground and cloud planes are walked along
+// lines of 2x2 blocks parallel to the horizon. View y is constant along each line so the plane
+// distance is too, which costs one divide per line, with texture coordinates stepped affinely
+// along it. Lines run along whichever screen axis is closer to the horizon, so they step at
+// most one block sideways per block and cover every block exactly once at any roll.
+// View directions are in 1/4096 units rather than fixed8_t for precise per block steps.
+void GameDrawLines()
+{
+	constexpr fixed16_t cloudHeight = 128;
+	constexpr int skyColour = 3;
+	constexpr int groundColour = 2;
+	constexpr uint8_t blocksWide = DISPLAY_WIDTH / 2;
+	constexpr uint8_t blocksHigh = (DISPLAY_HEIGHT - 16) / 2;
+	constexpr uint8_t mfdBlocksHigh = (DISPLAY_HEIGHT - 24) / 2;
+	constexpr uint8_t mfdBlocksWide = 40 / 2;
 
-				while (outY < limit) 
-				{
-					ditherWriter.Write(groundColour);
-					outY += 2;
-				}
-			}
-			if (ditherWriter.CanWrite() && viewDirTop.y < cloudThreshold)
-			{
-				// Draw distant sky span
-				int16_t limit = displayHeight;
+	const int16_t groundThreshold = interpSettings.groundThreshold.rawValue * 64;
+	const int16_t cloudThreshold = interpSettings.cloudThreshold.rawValue * 64;
 
-				if (viewDirBottom.y > cloudThreshold)
-				{
-					int16_t cloudY = FixedMath::QuickDivide((cloudThreshold - viewDirTop.y), viewDiff).rawValue;
-					if (cloudY < limit)
-						limit = cloudY;
-				}
+	Matrix3x3 cameraRotation = Matrix3x3::RotateX(interpSettings.cameraTilt) * camera.rotation;
+	const fixed8_t (&m)[3][3] = cameraRotation.m;
 
-				while (outY < limit) 
-				{
-					ditherWriter.Write(skyColour);
-					outY += 2;
-				}
-			}
-			if (ditherWriter.CanWrite())
-			{
-				// Cloud plane
-				DrawCloudSpan(ditherWriter, viewDirTop, viewDirBottom, outY, displayHeight - outY);
-			}
+	// View direction of the top left block and its change per block right and down
+	int16_t originDir[3], rightStep[3], downStep[3];
+	for (uint8_t n = 0; n < 3; n++)
+	{
+		originDir[n] = (m[2][n].rawValue - m[0][n].rawValue) * 64 + m[1][n].rawValue * 32;
+		rightStep[n] = m[0][n].rawValue * 2;
+		downStep[n] = -m[1][n].rawValue * 2;
+	}
+
+	// Lines run along the major axis, stepping sideways along the minor axis
+	bool xMajor = abs(rightStep[1]) <= abs(downStep[1]);
+	uint8_t majorLength = xMajor ? blocksWide : blocksHigh;
+	uint8_t minorLength = xMajor ? blocksHigh : blocksWide;
+	const int16_t* majorStep = xMajor ? rightStep : downStep;
+	const int16_t* minorStep = xMajor ? downStep : rightStep;
+
+	// Sideways blocks per block along the line, with 8 fractional bits. Walking the major axis
+	// backwards when the line slopes the other way keeps the sideways offsets positive.
+	int16_t slope = 0;
+	if (minorStep[1] != 0)
+	{
+		slope = (int16_t)(((int32_t)-majorStep[1] * 256) / minorStep[1]);
+	}
+	bool reversed = slope < 0;
+	if (reversed)
+	{
+		slope = -slope;
+	}
+
+	int16_t lineStart[3], lineStep[3];
+	for (uint8_t n = 0; n < 3; n++)
+	{
+		int16_t step = reversed ? -majorStep[n] : majorStep[n];
+		lineStart[n] = originDir[n] + (reversed ? majorStep[n] * (majorLength - 1) : 0);
+		lineStep[n] = step + (int16_t)(((int32_t)minorStep[n] * slope) >> 8);
+	}
+
+	uint8_t offsets[blocksWide];
+	for (uint8_t n = 0; n < majorLength; n++)
+	{
+		offsets[n] = (uint8_t)((n * slope + 128) >> 8);
+	}
+
+	// Line k covers minor position k + offsets[n] at major position n. Entry and exit are
+	// the first and last major positions on screen, which only move one way as k increases.
+	int8_t firstLine = -(int8_t)offsets[majorLength - 1];
+	uint8_t entry = majorLength - 1;
+	uint8_t exit = majorLength - 1;
+
+	for (int8_t k = firstLine; k < (int8_t)minorLength; k++)
+	{
+		while (entry > 0 && (int8_t)offsets[entry - 1] >= -k)
+			entry--;
+		while ((int8_t)offsets[exit] > (int8_t)minorLength - 1 - k)
+			exit--;
+
+		// View direction where the line comes on screen
+		int16_t lineDir[3];
+		for (uint8_t n = 0; n < 3; n++)
+		{
+			lineDir[n] = lineStart[n] + minorStep[n] * k + lineStep[n] * entry;
+		}
+
+		fixed16_t distance = 0;
+		uint8_t fillColour = 0;
+		const uint8_t* texture = nullptr;
+		if (lineDir[1] > cloudThreshold)
+		{
+			distance = FixedMath::QuickDivide(cloudHeight - camera.position.y, fixed8_t::FromRaw(lineDir[1] >> 6));
+			texture = cloudTexture;
 		}
-		else 
+		else if (lineDir[1] > 0)
 		{
-			// 90 degrees sideways
-			if (viewDirTop.y > cloudThreshold)
-			{
-				DrawCloudSpan(ditherWriter, viewDirTop, viewDirBottom, outY, displayHeight);
-			}
-			else if (viewDirTop.y > 0)
+			fillColour = skyColour;
+		}
+		else if (lineDir[1] > groundThreshold)
+		{
+			fillColour = groundColour;
+		}
+		else
+		{
+			distance = FixedMath::QuickDivide(fixed16_t(camera.position.y), fixed8_t::FromRaw(-(lineDir[1] >> 6)));
+			texture = mapTexture;
+		}
+
+		fixed16_t intersectionX = camera.position.x + fixed16_t::FromRaw((int16_t)(((int32_t)distance.rawValue * lineDir[0]) >> 12));
+		fixed16_t intersectionZ = camera.position.z + fixed16_t::FromRaw((int16_t)(((int32_t)distance.rawValue * lineDir[2]) >> 12));
+		fixed16_t deltaX = fixed16_t::FromRaw((int16_t)(((int32_t)distance.rawValue * lineStep[0] + 2048) >> 12));
+		fixed16_t deltaZ = fixed16_t::FromRaw((int16_t)(((int32_t)distance.rawValue * lineStep[2] + 2048) >> 12));
+
+		for (uint8_t n = entry; n <= exit; n++)
+		{
+			uint8_t major = reversed ? majorLength - 1 - n : n;
+			uint8_t minor = (uint8_t)(k + offsets[n]);
+			uint8_t blockX = xMajor ? major : minor;
+			uint8_t blockY = xMajor ? minor : major;
+
+			// Left and right thirds are obscured by MFD
+			if (blockY < mfdBlocksHigh || (uint8_t)(blockX - mfdBlocksWide) < blocksWide - mfdBlocksWide * 2)
 			{
-				while (outY < displayHeight)
+				uint8_t colour = fillColour;
+				if (texture == mapTexture)
 				{
-					ditherWriter.Write(skyColour);
-					outY += 2;
+					colour = ReadTextureFromWorldSpace<64>(mapTexture, intersectionX, intersectionZ);
 				}
-			}
-			else if (viewDirTop.y > groundThreshold)
-			{
-				while (outY < displayHeight)
+				else if (texture)
 				{
-					ditherWriter.Write(groundColour);
-					outY += 2;
+					colour = ReadTextureFromWorldSpace<32>(cloudTexture, intersectionX, intersectionZ);
 				}
+				WriteDitherBlock(blockX, blockY, colour);
 			}
-			else
-			{
-				DrawGroundSpan(ditherWriter, viewDirTop, viewDirBottom, outY, displayHeight);
-			}
+
+			intersectionX += deltaX;
+			intersectionZ += deltaZ;
 		}
 	}
 }
 
-
 void GameDrawSimple()
 {
 	constexpr fixed16_t groundHeight = 0;
@@ -487,6 +744,8 @@ void GameDrawSimple()
 
 	for (uint8_t y = 0; y < DISPLAY_HEIGHT; y++)
 	{
+		COUNT_AT(0, y);
+
 		const uint8_t* ditherPattern = (y & 1) == 0 ? ditherPattern1 : ditherPattern1 + 2;
 		uint8_t writePos = y & 7;
 		uint8_t writeMask = 1 << writePos;
@@ -521,6 +780,8 @@ void GameDrawSimple()
 
 		for (uint8_t x = 0; x < DISPLAY_WIDTH; x++)
 		{
+			COUNT_AT(x, y);
+
 			//fixed8_t worldDirX = fixed8_t::FromRaw(64 - x);
 			//fixed16_t intersectionX = intersectionMiddleX + worldDirX * rightXDistance;
 			//fixed16_t intersectionZ = intersectionMiddleZ + worldDirX * rightZDistance;
@@ -544,6 +805,7 @@ void GameDrawSimple()
 				colour = pgm_read_byte(&cloudTexture[v * 32 + u]);
 			}
 
+			COUNT_OP(PixelWrite);
 			uint8_t threshold = ditherPattern[x & 1];
 			if (colour >= threshold)
 			{
@@ -595,6 +857,8 @@ void GameDrawHalfRes()
 
 		for (uint8_t y = 0; y < displayHeight; y ++)
 		{
+			COUNT_AT(x, y);
+
 			uint8_t outColour = skyColour;
 
 			Vector3b worldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(y + 8));
@@ -634,6 +898,7 @@ void GameDrawHalfRes()
 				outColour = pgm_read_byte(&cloudTexture[index]);
 			}
 
+			COUNT_OP(PixelWrite);
 			uint8_t baseDitherIndex = (y & 1) << 1;
 
 			// Fill in 2x1 pixels based on dither pattern
@@ -699,6 +964,8 @@ void GameDrawQuarterRes()
 
 		for(uint8_t y = 0; y < displayHeight; y += 2)
 		{
+			COUNT_AT(x, y);
+
 			uint8_t outColour = skyColour;
 
 			Vector3b worldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(y + 8));
@@ -739,6 +1006,7 @@ void GameDrawQuarterRes()
 			}
 			
 			// Fill in 2x2 pixels based on dither pattern
+			COUNT_OP(DitherWrite);
 			if(outColour >= ditherPattern[0])
 			{
 				buffer1 |= writeMask;
@@ -823,6 +1091,8 @@ void GameDrawFullRes()
 
 		for (uint8_t y = 0; y < displayHeight; y++)
 		{
+			COUNT_AT(x, y);
+
 			uint8_t outColour = skyColour;
 
 			Vector3b worldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(y + 8));
@@ -856,6 +1126,7 @@ void GameDrawFullRes()
 				outColour = pgm_read_byte(&cloudTexture[index]);
 			}
 
+			COUNT_OP(PixelWrite);
 			if (outColour >= ditherPattern[y & 1])
 			{
 				buffer |= writeMask;
@@ -877,6 +1148,8 @@ void GameDrawFullRes()
 
 void GameDrawHUD()
 {
+	PROFILE_SCOPE(HUD);
+
 	uint8_t* bufferPtr = &Platform::GetScreenBuffer()[40];
 	(*bufferPtr) = 1;
 	bufferPtr += DISPLAY_WIDTH;
@@ -902,8 +1175,14 @@ void GameDrawHUD()
 
 void Game::Draw()
 {
+	PROFILE_SCOPE(Draw);
+
 	static int drawMethod = 3;
 
+#if MEMORY_STATS
+	MemoryStats::BeginMeasure();
+#endif
+
 	switch (drawMethod)
 	{
 	case 0:
@@ -922,10 +1201,20 @@ void Game::Draw()
 		GameDrawInterp();
 		break;
 	case 4:
+		GameDrawLines();
+		break;
+	case 5:
+		GameDrawGrid();
+		break;
+	case 6:
 		GameDrawSimple();
 		break;
 	}
 
+#if MEMORY_STATS
+	MemoryStats::drawStackUsage = MemoryStats::EndMeasure();
+#endif
+
 	GameDrawHUD();
 
 	static uint8_t oldButtons = Platform::GetInput();
@@ -933,7 +1222,7 @@ void Game::Draw()
 	{
 		if (Platform::GetInput() & INPUT_B)
 		{
-			drawMethod = (drawMethod + 1) % 4;
+			drawMethod = (drawMethod + 1) % 6;
 		}
 	}
 	
@@ -942,6 +1231,8 @@ void Game::Draw()
 
 void Game::Tick()
 {
+	PROFILE_SCOPE(Tick);
+
 	if (Platform::GetInput() & INPUT_DOWN)
 	{
 		camera.pitch++;
@@ -969,8 +1260,7 @@ void Game::Tick()
 
 	camera.yaw += turn;
 
-	camera.rotation = Matrix3x3::RotateZ(camera.roll) * Matrix3x3::RotateX(-camera.pitch) * Matrix3x3::RotateY(-camera.yaw);
-	camera.invRotation = camera.rotation.Transpose();
+	camera.UpdateRotation();
 	camera.position = camera.position + Vector3s(camera.rotation.Forward());
 
 	if (camera.position.y < 1)
@@ -1,6 +1,61 @@
 #pragma once
 
 #include <stdint.h>
+#include "FixedMath.h"
+
+struct Camera
+{
+	Vector3s position;
+	Matrix3x3 rotation;
+	Matrix3x3 invRotation;
+	angle_t pitch, roll, yaw;
+
+	// Rebuild rotation and invRotation from pitch, roll and yaw
+	void UpdateRotation();
+};
+
+extern Camera camera;
+
+// Blend between two view directions, alpha is 0 to 1 (raw 0 to 64)
+inline Vector3b Lerp(const Vector3b& a, const Vector3b& b, fixed8_t alpha)
+{
+	COUNT_OP(Lerp);
+
+	const fixed8_t oneMinusAlpha = fixed8_t::FromRaw(64 - alpha.rawValue);
+	return Vector3b(
+		fixed8_t::FromRaw((a.x.rawValue * oneMinusAlpha.rawValue + b.x.rawValue * alpha.rawValue) >> FixedFractionalBits),
+		fixed8_t::FromRaw((a.y.rawValue * oneMinusAlpha.rawValue + b.y.rawValue * alpha.rawValue) >> FixedFractionalBits),
+		fixed8_t::FromRaw((a.z.rawValue * oneMinusAlpha.rawValue + b.z.rawValue * alpha.rawValue) >> FixedFractionalBits));
+}
+
+// Hand picked constants that control the quality and cost of GameDrawInterp
+struct InterpSettings
+{
+	fixed8_t interpThreshold;		// GameDrawGrid interpolates cells with every corner below this view direction y
+	fixed8_t groundThreshold;		// below this is ground texture
+	fixed8_t cloudThreshold;		// above this is cloud texture
+	uint8_t blockShift;				// affine cloud blocks are 1 << blockShift 2x2 pixel blocks high
+	angle_t cameraTilt;				// view is rotated down a bit because the bottom area is obscured
+	fixed8_t maxTexelError;			// affine ground runs may drift this many texels from perspective correct
+	uint8_t maxSpanSplits;			// after this many splits the rest of a ground span takes the longest runs
+};
+
+constexpr InterpSettings defaultInterpSettings =
+{
+	fixed8_t::FromRaw(-6),
+	fixed8_t::FromRaw(-3),
+	fixed8_t::FromRaw(8),
+	2,
+	4,
+	fixed8_t::FromRaw(16),
+	1
+};
+
+#if INTERP_TUNING
+extern InterpSettings interpSettings;
+#else
+constexpr InterpSettings interpSettings = defaultInterpSettings;
+#endif
 
 class Game
 {
@@ -14,3 +69,13 @@ public:
 private:
 
 };
+
+// Individual renderers, selected between by Game::Draw
+void GameDrawQuarterRes();
+void GameDrawHalfRes();
+void GameDrawFullRes();
+void GameDrawInterp();
+void GameDrawLines();
+void GameDrawGrid();
+void GameDrawSimple();
+void GameDrawHUD();
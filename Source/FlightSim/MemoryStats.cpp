@@ -0,0 +1,160 @@
+#include "Defines.h"
+#include "MemoryStats.h"
+#include "Profiler.h"
+
+#if MEMORY_STATS
+
+#if _WIN32 || __linux__
+#error MEMORY_STATS is only supported on the AVR
+#endif
+
+// Symbol from the avr-libc linker script, __bss_end is declared in MemoryStats.h
+extern uint8_t __data_start;
+
+uint16_t MemoryStats::zoneStackUsage[(int)ProfileZone::NumZones];
+uint16_t MemoryStats::drawStackUsage;
+#if PROFILER
+uint32_t MemoryStats::paintTime;
+#endif
+
+static uint16_t stackHighWater;
+
+static const char zoneNames[(int)ProfileZone::NumZones][14] PROGMEM =
+{
+	"Tick",
+	"Draw",
+	"CloudSpan",
+	"SkyFill",
+	"DistantGround",
+	"GroundSpan",
+	"HUD"
+};
+
+// Runs from .init1 before the C runtime has set up the stack pointer or zeroed r1, so
+// has to be assembly. Paints from the end of .bss to the top of SRAM.
+extern "C" void PaintStack() __attribute__((naked, used, section(".init1")));
+extern "C" void PaintStack()
+{
+	asm volatile(
+		"	ldi r30, lo8(__bss_end)\n"
+		"	ldi r31, hi8(__bss_end)\n"
+		"	ldi r24, %[paint]\n"
+		"	ldi r25, hi8(%[ramEnd])\n"
+		"	rjmp 2f\n"
+		"1:	st Z+, r24\n"
+		"2:	cpi r30, lo8(%[ramEnd])\n"
+		"	cpc r31, r25\n"
+		"	brlo 1b\n"
+		"	breq 1b\n"
+		:
+		: [paint] "M" (MemoryStats::paintValue), [ramEnd] "i" (RAMEND)
+	);
+}
+
+// Deepest stack since the last paint
+static uint16_t ScanStack()
+{
+	const uint8_t* ptr = &__bss_end;
+	while (ptr <= (const uint8_t*)RAMEND && *ptr == MemoryStats::paintValue)
+	{
+		ptr++;
+	}
+	return MemoryStats::GetStackDepth(ptr);
+}
+
+uint16_t MemoryStats::GetStaticSize()
+{
+	return (uint16_t)&__bss_end - (uint16_t)&__data_start;
+}
+
+uint16_t MemoryStats::GetStackUsage()
+{
+	uint16_t usage = ScanStack();
+	if (usage > stackHighWater)
+	{
+		stackHighWater = usage;
+	}
+	return stackHighWater;
+}
+
+uint16_t MemoryStats::GetMinFreeStack()
+{
+	return RAMEND + 1 - (uint16_t)&__bss_end - GetStackUsage();
+}
+
+void MemoryStats::BeginMeasure()
+{
+#if PROFILER
+	uint32_t paintStart = micros();
+#endif
+	GetStackUsage();
+
+	// Leaves a margin for this function's own frame
+	uint8_t* ptr = &__bss_end;
+	uint8_t* end = (uint8_t*)SP - 16;
+	while (ptr < end)
+	{
+		*ptr++ = paintValue;
+	}
+#if PROFILER
+	paintTime += micros() - paintStart;
+#endif
+}
+
+uint16_t MemoryStats::EndMeasure()
+{
+#if PROFILER
+	uint32_t scanStart = micros();
+#endif
+	uint16_t usage = ScanStack();
+	GetStackUsage();
+#if PROFILER
+	paintTime += micros() - scanStart;
+#endif
+	return usage;
+}
+
+static void WriteString_P(MemoryStats::WriteChar writeChar, const char* str)
+{
+	char c;
+	while ((c = pgm_read_byte(str++)) != 0)
+	{
+		writeChar(c);
+	}
+}
+
+static void WriteStat(MemoryStats::WriteChar writeChar, const char* name, uint16_t value)
+{
+	char digits[6];
+	uint8_t numDigits = 0;
+
+	do
+	{
+		digits[numDigits++] = '0' + value % 10;
+		value /= 10;
+	} while (value);
+
+	WriteString_P(writeChar, name);
+	writeChar(' ');
+	while (numDigits)
+	{
+		writeChar(digits[--numDigits]);
+	}
+	writeChar('\n');
+}
+
+void MemoryStats::Report(WriteChar writeChar)
+{
+	WriteStat(writeChar, PSTR("static"), GetStaticSize());
+	WriteStat(writeChar, PSTR("stack"), GetStackUsage());
+	WriteStat(writeChar, PSTR("free"), GetMinFreeStack());
+	WriteStat(writeChar, PSTR("draw"), drawStackUsage);
+
+	for (int n = 0; n < (int)ProfileZone::NumZones; n++)
+	{
+		WriteString_P(writeChar, PSTR("zone "));
+		WriteStat(writeChar, zoneNames[n], zoneStackUsage[n]);
+	}
+}
+
+#endif
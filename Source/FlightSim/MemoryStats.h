@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+
+// SRAM usage on the ATmega32u4. The free RAM between the end of .bss and the top of the stack
+// is painted at boot, so the deepest the stack has reached can be found by scanning for the
+// first overwritten byte. Build with MEMORY_STATS=1 to enable, otherwise STACK_SCOPE compiles away.
+// Depths are in bytes from the top of SRAM.
+// With PROFILER=1 the time spent painting and scanning is left out of the zone times, though the
+// micros() calls that measure it mean a zone reports at least the depth of that call.
+
+enum class ProfileZone : uint8_t;
+
+#if MEMORY_STATS
+#include <avr/io.h>
+#if PROFILER
+#include <Arduino.h>
+#endif
+
+class MemoryStats
+{
+public:
+	static constexpr uint8_t paintValue = 0xc5;
+
+	// Bytes below the stack pointer painted on entry to each zone. Span helpers are close to
+	// leaf functions so this is enough for them; larger zones report at least this depth.
+	static constexpr uint8_t zoneWindow = 64;
+
+	// Deepest stack seen within each zone, and during the last renderer call
+	static uint16_t zoneStackUsage[];
+	static uint16_t drawStackUsage;
+
+#if PROFILER
+	// Microseconds spent painting and scanning since boot, which ProfileScope subtracts
+	static uint32_t paintTime;
+#endif
+
+	// Bytes of stack in use when ptr is the deepest byte written
+	static uint16_t GetStackDepth(const uint8_t* ptr)
+	{
+		return RAMEND + 1 - (uint16_t)ptr;
+	}
+
+	// .data plus .bss
+	static uint16_t GetStaticSize();
+	// Deepest stack since boot and the SRAM it never reached
+	static uint16_t GetStackUsage();
+	static uint16_t GetMinFreeStack();
+
+	// Repaints everything below the current stack pointer, then measures the deepest
+	// stack since. The high water mark from before the repaint is kept.
+	static void BeginMeasure();
+	static uint16_t EndMeasure();
+
+	// Writes a line of text per stat
+	typedef void (*WriteChar)(char c);
+	static void Report(WriteChar writeChar);
+};
+
+// End of .bss, where the painted free RAM starts
+extern uint8_t __bss_end;
+
+// Always inlined, so that measuring doesn't push anything inside the painted window itself
+struct StackScope
+{
+	__attribute__((always_inline)) StackScope(ProfileZone inZone) : zone(inZone), windowTop((uint8_t*)SP)
+	{
+#if PROFILER
+		uint32_t paintStart = micros();
+#endif
+		// With less free stack than the window, stop at .bss rather than paint over globals
+		uint16_t bottom = (uint16_t)windowTop - (MemoryStats::zoneWindow - 1);
+		windowBottom = bottom < (uint16_t)&__bss_end ? &__bss_end : (uint8_t*)bottom;
+
+		for (uint8_t* ptr = windowBottom; ptr <= windowTop; ptr++)
+		{
+			*ptr = MemoryStats::paintValue;
+		}
+#if PROFILER
+		MemoryStats::paintTime += micros() - paintStart;
+#endif
+	}
+
+	__attribute__((always_inline)) ~StackScope()
+	{
+#if PROFILER
+		uint32_t scanStart = micros();
+#endif
+		uint8_t* ptr = windowBottom;
+		while (ptr <= windowTop && *ptr == MemoryStats::paintValue)
+		{
+			ptr++;
+		}
+
+		uint16_t depth = MemoryStats::GetStackDepth(ptr);
+		if (depth > MemoryStats::zoneStackUsage[(int)zone])
+		{
+			MemoryStats::zoneStackUsage[(int)zone] = depth;
+		}
+#if PROFILER
+		MemoryStats::paintTime += micros() - scanStart;
+#endif
+	}
+
+	ProfileZone zone;
+	uint8_t* windowTop;
+	uint8_t* windowBottom;
+};
+
+#define STACK_SCOPE_NAME2(line) stackScope_##line
+#define STACK_SCOPE_NAME(line) STACK_SCOPE_NAME2(line)
+#define STACK_SCOPE(zone) StackScope STACK_SCOPE_NAME(__LINE__)(ProfileZone::zone)
+#else
+#define STACK_SCOPE(zone)
+#endif
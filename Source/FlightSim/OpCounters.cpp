@@ -0,0 +1,80 @@
+#include "Defines.h"
+#include "OpCounters.h"
+#include <string.h>
+
+#if OP_COUNTERS
+
+uint32_t OpCounters::counts[(int)OpCounter::NumCounters];
+uint16_t OpCounters::cellCounts[(int)OpCounter::NumCounters][numPages][DISPLAY_WIDTH];
+uint8_t OpCounters::currentColumn, OpCounters::currentPage;
+
+struct OpCostInfo
+{
+	const char* name;
+	uint16_t cycles;
+};
+
+// Estimated ATmega32u4 cycles per operation, based on the avr-gcc output for each routine.
+// There is no barrel shifter so the fixed point >> 6 normalisation after each multiply
+// dominates the arithmetic cost.
+static const OpCostInfo opCostTable[(int)OpCounter::NumCounters] =
+{
+	{ "QuickDivide", 48 },				// 16x16->32 multiply + 32 bit >> 4
+	{ "pgm_read_byte", 5 },				// LPM + Z pointer setup
+	{ "pgm_read_word", 8 },				// 2x LPM Z+ + Z pointer setup
+	{ "Lerp", 72 },						// 6x MULS, 3x 16 bit >> 6
+	{ "DitherWriter::Write", 24 },		// 4 compare / OR pairs, amortised page store
+	{ "Pixel write", 10 },				// 1-2 compare / OR pairs, amortised page store
+	{ "Block write", 30 },				// Page address, 2 table lookups, 2 byte read-modify-writes
+	{ "Span error test", 32 },			// 2 16 bit abs, 16x8 and 16x16 multiplies, 32 bit compare
+	{ "Matrix3x3 * Matrix3x3", 520 },	// 27 fixed8 multiply-accumulates
+	{ "Matrix3x3 * Vector3b", 170 },	// 9 fixed8 multiply-accumulates
+	{ "Matrix3x3 * Vector3s", 430 },	// 9 fixed16 x fixed8 multiply-accumulates via 32 bit
+};
+
+void OpCounters::Reset()
+{
+	for (int n = 0; n < (int)OpCounter::NumCounters; n++)
+	{
+		counts[n] = 0;
+	}
+
+	memset(cellCounts, 0, sizeof(cellCounts));
+	currentColumn = currentPage = 0;
+}
+
+const char* OpCounters::GetName(OpCounter op)
+{
+	return opCostTable[(int)op].name;
+}
+
+uint16_t OpCounters::GetCycleWeight(OpCounter op)
+{
+	return opCostTable[(int)op].cycles;
+}
+
+uint32_t OpCounters::EstimateCycles()
+{
+	uint32_t total = 0;
+
+	for (int n = 0; n < (int)OpCounter::NumCounters; n++)
+	{
+		total += counts[n] * opCostTable[n].cycles;
+	}
+
+	return total;
+}
+
+uint32_t OpCounters::EstimateCellCycles(uint8_t column, uint8_t page)
+{
+	uint32_t total = 0;
+
+	for (int n = 0; n < (int)OpCounter::NumCounters; n++)
+	{
+		total += (uint32_t)cellCounts[n][page][column] * opCostTable[n].cycles;
+	}
+
+	return total;
+}
+
+#endif
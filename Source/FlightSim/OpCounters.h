@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+
+// Hot path operation counters, used on the host to estimate AVR cycle cost.
+// Only compiled in when building with OP_COUNTERS=1, otherwise COUNT_OP does nothing.
+
+enum class OpCounter : uint8_t
+{
+	QuickDivide,				// Excludes the recipTable read, which is counted as ProgmemReadWord
+	ProgmemReadByte,
+	ProgmemReadWord,
+	Lerp,
+	DitherWrite,
+	PixelWrite,					// Single inline dither compare and store outside of DitherWriter
+	BlockWrite,					// 2x2 dither block written in place by GameDrawLines
+	SpanErrorTest,				// Affine run error estimate in DrawGroundSpan
+	MatrixMultiply,				// Matrix3x3 * Matrix3x3
+	MatrixVectorMultiply,		// Matrix3x3 * Vector3b
+	MatrixVectorMultiplyWide,	// Matrix3x3 * Vector3s
+	NumCounters
+};
+
+#if OP_COUNTERS
+class OpCounters
+{
+public:
+	static constexpr uint32_t cyclesPerFrame = 16000000 / TARGET_FRAMERATE;
+	static constexpr int numPages = DISPLAY_HEIGHT / 8;
+
+	static uint32_t counts[(int)OpCounter::NumCounters];
+
+	// Counts broken down by the screen column and 8 pixel page that the renderer was working
+	// on at the time, as set by COUNT_AT. Used to build render cost heatmaps.
+	static uint16_t cellCounts[(int)OpCounter::NumCounters][numPages][DISPLAY_WIDTH];
+	static uint8_t currentColumn, currentPage;
+
+	static void Reset();
+	static const char* GetName(OpCounter op);
+	static uint16_t GetCycleWeight(OpCounter op);
+	static uint32_t EstimateCycles();
+	static uint32_t EstimateCellCycles(uint8_t column, uint8_t page);
+
+	static inline void Count(OpCounter op)
+	{
+		counts[(int)op]++;
+		cellCounts[(int)op][currentPage][currentColumn]++;
+	}
+
+	static inline void SetLocation(int x, int y)
+	{
+		currentColumn = (uint8_t)x & (DISPLAY_WIDTH - 1);
+		currentPage = (uint8_t)(y >> 3) & (numPages - 1);
+	}
+};
+
+#define COUNT_OP(op) OpCounters::Count(OpCounter::op)
+// Attribute following operations to the pixel at x, y
+#define COUNT_AT(x, y) OpCounters::SetLocation(x, y)
+// Attribute following operations to the pixel written through this screen buffer pointer
+#define COUNT_AT_BUFFER(ptr) COUNT_AT(((ptr) - Platform::GetScreenBuffer()) % DISPLAY_WIDTH, (((ptr) - Platform::GetScreenBuffer()) / DISPLAY_WIDTH) * 8)
+#else
+#define COUNT_OP(op) ((void)0)
+#define COUNT_AT(x, y) ((void)0)
+#define COUNT_AT_BUFFER(ptr) ((void)0)
+#endif
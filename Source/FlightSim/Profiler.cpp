@@ -0,0 +1,139 @@
+#include "Defines.h"
+#include "Profiler.h"
+#include "Platform.h"
+#include "Font.h"
+
+#if PROFILER
+
+#if _WIN32 || __linux__
+#include <chrono>
+#else
+#include <Arduino.h>
+#endif
+
+uint32_t Profiler::zoneTimes[(int)ProfileZone::NumZones];
+uint16_t Profiler::zoneCounts[(int)ProfileZone::NumZones];
+
+static const char* const zoneNames[(int)ProfileZone::NumZones] =
+{
+	"Tick",
+	"Draw",
+	"CloudSpan",
+	"SkyFill",
+	"DistantGround",
+	"GroundSpan",
+	"HUD"
+};
+
+// Stages shown on the overlay, each made up of one or more zones
+enum class OverlayStage : uint8_t
+{
+	Sky,
+	Cloud,
+	Ground,
+	HUD,
+	Tick,
+	NumStages
+};
+
+constexpr int numOverlayStages = (int)OverlayStage::NumStages;
+constexpr uint8_t overlayWindowSize = 8;
+constexpr uint8_t overlayColumnWidth = DISPLAY_WIDTH / numOverlayStages;
+constexpr uint32_t frameBudgetMicros = 1000000 / TARGET_FRAMERATE;
+
+static const char overlayLabels[numOverlayStages][2] PROGMEM = { "S", "C", "G", "H", "T" };
+
+static uint16_t stageHistory[numOverlayStages][overlayWindowSize];
+static uint8_t stageHistoryPos;
+
+static uint16_t ToMicros(uint32_t time);
+
+void Profiler::BeginFrame()
+{
+	for (int n = 0; n < (int)ProfileZone::NumZones; n++)
+	{
+		zoneTimes[n] = 0;
+		zoneCounts[n] = 0;
+	}
+}
+
+void Profiler::EndFrame()
+{
+	uint16_t* history = &stageHistory[0][stageHistoryPos];
+
+	history[(int)OverlayStage::Sky * overlayWindowSize] = ToMicros(zoneTimes[(int)ProfileZone::SkyFill]);
+	history[(int)OverlayStage::Cloud * overlayWindowSize] = ToMicros(zoneTimes[(int)ProfileZone::CloudSpan]);
+	history[(int)OverlayStage::Ground * overlayWindowSize] = ToMicros(zoneTimes[(int)ProfileZone::DistantGround] + zoneTimes[(int)ProfileZone::GroundSpan]);
+	history[(int)OverlayStage::HUD * overlayWindowSize] = ToMicros(zoneTimes[(int)ProfileZone::HUD]);
+	history[(int)OverlayStage::Tick * overlayWindowSize] = ToMicros(zoneTimes[(int)ProfileZone::Tick]);
+
+	stageHistoryPos = (stageHistoryPos + 1) % overlayWindowSize;
+}
+
+void Profiler::DrawOverlay()
+{
+	uint8_t* screenPtr = Platform::GetScreenBuffer();
+	uint8_t x = 0;
+
+	for (int stage = 0; stage < numOverlayStages; stage++)
+	{
+		uint32_t total = 0;
+		for (int n = 0; n < overlayWindowSize; n++)
+		{
+			total += stageHistory[stage][n];
+		}
+		uint16_t average = (uint16_t)(total / overlayWindowSize);
+
+		// Stacked bar along the top of the screen where the full width is the frame budget.
+		// Alternate solid and hollow segments so that neighbouring stages can be told apart.
+		uint8_t pattern = (stage & 1) ? 0x28 : 0x38;
+		uint16_t width = (uint16_t)(((uint32_t)average * DISPLAY_WIDTH) / frameBudgetMicros);
+
+		while (width > 0 && x < DISPLAY_WIDTH)
+		{
+			screenPtr[x] = (screenPtr[x] & 0xc7) | pattern;
+			x++;
+			width--;
+		}
+
+		// Numeric readout in microseconds underneath
+		uint8_t textX = stage * overlayColumnWidth;
+		Font::PrintString(overlayLabels[stage], 1, textX);
+		Font::PrintInt(average, 1, textX + Font::glyphWidth);
+	}
+}
+
+const char* Profiler::GetZoneName(ProfileZone zone)
+{
+	return zoneNames[(int)zone];
+}
+
+#if _WIN32 || __linux__
+const char* const Profiler::timeUnit = "ns";
+Profiler::ZoneListener Profiler::zoneListener;
+
+static uint16_t ToMicros(uint32_t time)
+{
+	return (uint16_t)(time / 1000);
+}
+
+uint32_t Profiler::GetTime()
+{
+	// Wraps every ~4 seconds which is fine as only differences are used
+	return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#else
+const char* const Profiler::timeUnit = "us";
+
+static uint16_t ToMicros(uint32_t time)
+{
+	return (uint16_t)time;
+}
+
+uint32_t Profiler::GetTime()
+{
+	return micros();
+}
+#endif
+
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+#include "MemoryStats.h"
+
+// Scoped timing zones. Build with PROFILER=1 to enable, otherwise PROFILE_SCOPE compiles away.
+// Times are in microseconds from micros() on the device and nanoseconds from std::chrono on the host.
+// With MEMORY_STATS=1 each zone also records its peak stack depth, and the time spent measuring
+// it is left out of the zone times.
+
+enum class ProfileZone : uint8_t
+{
+	Tick,
+	Draw,
+	CloudSpan,
+	SkyFill,
+	DistantGround,
+	GroundSpan,
+	HUD,
+	NumZones
+};
+
+#if PROFILER
+class Profiler
+{
+public:
+	// Accumulated time and number of entries for each zone since the last BeginFrame
+	static uint32_t zoneTimes[(int)ProfileZone::NumZones];
+	static uint16_t zoneCounts[(int)ProfileZone::NumZones];
+
+	static const char* const timeUnit;
+
+	static void BeginFrame();
+	static uint32_t GetTime();
+	static const char* GetZoneName(ProfileZone zone);
+
+	// GetTime less any time spent painting and scanning the stack
+	static uint32_t GetZoneTime()
+	{
+#if MEMORY_STATS
+		return GetTime() - MemoryStats::paintTime;
+#else
+		return GetTime();
+#endif
+	}
+
+	// Overlay of per stage timings averaged over the last few frames. Call EndFrame once
+	// the frame has been drawn, then DrawOverlay to draw on top of it.
+	static void EndFrame();
+	static void DrawOverlay();
+
+#if _WIN32 || __linux__
+	// Called as each zone closes, so host tools can record individual zone entries
+	typedef void (*ZoneListener)(ProfileZone zone, uint32_t startTime, uint32_t endTime);
+	static ZoneListener zoneListener;
+#endif
+};
+
+struct ProfileScope
+{
+	ProfileScope(ProfileZone inZone) : zone(inZone), startTime(Profiler::GetZoneTime()) {}
+
+	~ProfileScope()
+	{
+		uint32_t endTime = Profiler::GetZoneTime();
+		Profiler::zoneTimes[(int)zone] += endTime - startTime;
+		Profiler::zoneCounts[(int)zone]++;
+#if _WIN32 || __linux__
+		if (Profiler::zoneListener)
+		{
+			Profiler::zoneListener(zone, startTime, endTime);
+		}
+#endif
+	}
+
+	ProfileZone zone;
+	uint32_t startTime;
+};
+
+#define PROFILE_SCOPE_NAME2(line) profileScope_##line
+#define PROFILE_SCOPE_NAME(line) PROFILE_SCOPE_NAME2(line)
+#define PROFILE_TIMER_SCOPE(zone) ProfileScope PROFILE_SCOPE_NAME(__LINE__)(ProfileZone::zone)
+#else
+#define PROFILE_TIMER_SCOPE(zone)
+#endif
+
+#define PROFILE_SCOPE(zone) PROFILE_TIMER_SCOPE(zone); STACK_SCOPE(zone)
@@ -0,0 +1,195 @@
+#include "Defines.h"
+#include "Replay.h"
+#include "Game.h"
+#include "FixedMath.h"
+
+#if _WIN32 || __linux__
+#include <stdio.h>
+#endif
+
+static const uint8_t* playbackPtr;
+static uint8_t playbackTicksLeft;
+static uint8_t playbackInput;
+
+static uint16_t ReadWord(const uint8_t* ptr)
+{
+	return pgm_read_byte(ptr) | (pgm_read_byte(ptr + 1) << 8);
+}
+
+static void ReadNextRun()
+{
+	playbackTicksLeft = pgm_read_byte(playbackPtr);
+	playbackInput = pgm_read_byte(playbackPtr + 1);
+	playbackPtr += 2;
+
+	if (!playbackTicksLeft)
+	{
+		playbackPtr = nullptr;
+	}
+}
+
+bool Replay::BeginPlayback(const uint8_t* data)
+{
+	if (pgm_read_byte(data) != 'M' || pgm_read_byte(data + 1) != 'F' || pgm_read_byte(data + 2) != 'R' || pgm_read_byte(data + 3) != version)
+	{
+		return false;
+	}
+
+	SeedRandom(ReadWord(data + 4));
+	camera.position.x = fixed16_t::FromRaw((int16_t)ReadWord(data + 6));
+	camera.position.y = fixed16_t::FromRaw((int16_t)ReadWord(data + 8));
+	camera.position.z = fixed16_t::FromRaw((int16_t)ReadWord(data + 10));
+	camera.pitch = pgm_read_byte(data + 12);
+	camera.roll = pgm_read_byte(data + 13);
+	camera.yaw = pgm_read_byte(data + 14);
+	camera.UpdateRotation();
+
+	playbackPtr = data + headerSize;
+	ReadNextRun();
+	return true;
+}
+
+bool Replay::IsPlaying()
+{
+	return playbackPtr != nullptr;
+}
+
+uint8_t Replay::NextInput()
+{
+	if (!playbackPtr)
+	{
+		return 0;
+	}
+
+	uint8_t input = playbackInput;
+	if (--playbackTicksLeft == 0)
+	{
+		ReadNextRun();
+	}
+	return input;
+}
+
+#if _WIN32 || __linux__
+static std::vector<uint8_t> recording;
+static bool isRecording = false;
+static uint8_t recordTicks;
+static uint8_t recordInput;
+
+static void WriteWord(std::vector<uint8_t>& data, uint16_t value)
+{
+	data.push_back((uint8_t)value);
+	data.push_back((uint8_t)(value >> 8));
+}
+
+static void FlushRun()
+{
+	if (recordTicks)
+	{
+		recording.push_back(recordTicks);
+		recording.push_back(recordInput);
+		recordTicks = 0;
+	}
+}
+
+void Replay::BeginRecording(uint16_t seed)
+{
+	recording.clear();
+	recording.push_back('M');
+	recording.push_back('F');
+	recording.push_back('R');
+	recording.push_back((uint8_t)version);
+	WriteWord(recording, seed);
+	WriteWord(recording, (uint16_t)camera.position.x.rawValue);
+	WriteWord(recording, (uint16_t)camera.position.y.rawValue);
+	WriteWord(recording, (uint16_t)camera.position.z.rawValue);
+	recording.push_back(camera.pitch);
+	recording.push_back(camera.roll);
+	recording.push_back(camera.yaw);
+
+	recordTicks = 0;
+	isRecording = true;
+}
+
+bool Replay::IsRecording()
+{
+	return isRecording;
+}
+
+void Replay::RecordInput(uint8_t input)
+{
+	if (!isRecording)
+	{
+		return;
+	}
+
+	if (recordTicks && (input != recordInput || recordTicks == maxRunLength))
+	{
+		FlushRun();
+	}
+
+	recordInput = input;
+	recordTicks++;
+}
+
+const std::vector<uint8_t>& Replay::EndRecording()
+{
+	if (isRecording)
+	{
+		FlushRun();
+		recording.push_back(0);
+		recording.push_back(0);
+		isRecording = false;
+	}
+	return recording;
+}
+
+bool Replay::Load(const char* filename, std::vector<uint8_t>& outData)
+{
+	FILE* fs = fopen(filename, "rb");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", filename);
+		return false;
+	}
+
+	outData.clear();
+	uint8_t buffer[256];
+	size_t numRead;
+	while ((numRead = fread(buffer, 1, sizeof(buffer), fs)) > 0)
+	{
+		outData.insert(outData.end(), buffer, buffer + numRead);
+	}
+	fclose(fs);
+
+	// Every run is two bytes and the last is the terminator
+	if (outData.size() < headerSize + 2 || (outData.size() - headerSize) % 2 || outData[outData.size() - 2] != 0)
+	{
+		printf("%s is not a valid replay\n", filename);
+		return false;
+	}
+	return true;
+}
+
+bool Replay::Save(const char* filename, const std::vector<uint8_t>& data)
+{
+	FILE* fs = fopen(filename, "wb");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", filename);
+		return false;
+	}
+	fwrite(data.data(), 1, data.size(), fs);
+	fclose(fs);
+	return true;
+}
+
+uint32_t Replay::GetNumTicks(const uint8_t* data)
+{
+	uint32_t numTicks = 0;
+	for (const uint8_t* run = data + headerSize; *run; run += 2)
+	{
+		numTicks += *run;
+	}
+	return numTicks;
+}
+#endif
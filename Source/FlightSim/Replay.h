@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+
+// Input replays: the random seed and starting camera, then the Platform::GetInput() mask
+// for every Game::Tick, run length encoded. Playing one back from the same start gives
+// exactly the same flight on any build.
+//
+// Format, multi byte values little endian:
+//   'M' 'F' 'R' version
+//   seed (2 bytes)
+//   camera position x, y, z as raw fixed16_t (2 bytes each)
+//   camera pitch, roll, yaw (1 byte each)
+//   runs of { ticks, input mask }, ending with a run of 0 ticks
+//
+// Playback reads with pgm_read_byte so on the device the replay lives in PROGMEM.
+// Recording is host only.
+
+#if _WIN32 || __linux__
+#include <vector>
+#endif
+
+class Replay
+{
+public:
+	static constexpr uint8_t version = 1;
+	static constexpr uint8_t headerSize = 15;
+	static constexpr uint8_t maxRunLength = 255;
+
+	// Seeds Random() and places the camera, so call after Game::Init.
+	// Returns false if the data isn't a replay.
+	static bool BeginPlayback(const uint8_t* data);
+	static bool IsPlaying();
+
+	// Input mask for the next tick. Playback stops as the last input is read, so IsPlaying() is
+	// already false during the last tick, after which this returns 0.
+	static uint8_t NextInput();
+
+#if _WIN32 || __linux__
+	// The seed should be the one last passed to SeedRandom, the camera is captured now
+	static void BeginRecording(uint16_t seed);
+	static bool IsRecording();
+	static void RecordInput(uint8_t input);
+	static const std::vector<uint8_t>& EndRecording();
+
+	static bool Load(const char* filename, std::vector<uint8_t>& outData);
+	static bool Save(const char* filename, const std::vector<uint8_t>& data);
+	static uint32_t GetNumTicks(const uint8_t* data);
+#endif
+};
@@ -0,0 +1,58 @@
+#include "StateHash.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+
+constexpr uint32_t fnvOffsetBasis = 2166136261u;
+constexpr uint32_t fnvPrime = 16777619u;
+
+static uint32_t HashByte(uint32_t hash, uint8_t value)
+{
+	return (hash ^ value) * fnvPrime;
+}
+
+static uint32_t HashWord(uint32_t hash, uint16_t value)
+{
+	return HashByte(HashByte(hash, (uint8_t)value), (uint8_t)(value >> 8));
+}
+
+static uint32_t HashMatrix(uint32_t hash, const Matrix3x3& matrix)
+{
+	for (uint8_t row = 0; row < 3; row++)
+	{
+		for (uint8_t column = 0; column < 3; column++)
+		{
+			hash = HashByte(hash, (uint8_t)matrix.m[row][column].rawValue);
+		}
+	}
+	return hash;
+}
+
+uint32_t StateHash::HashState()
+{
+	uint32_t hash = fnvOffsetBasis;
+
+	hash = HashWord(hash, (uint16_t)camera.position.x.rawValue);
+	hash = HashWord(hash, (uint16_t)camera.position.y.rawValue);
+	hash = HashWord(hash, (uint16_t)camera.position.z.rawValue);
+	hash = HashByte(hash, camera.pitch);
+	hash = HashByte(hash, camera.roll);
+	hash = HashByte(hash, camera.yaw);
+	hash = HashMatrix(hash, camera.rotation);
+	hash = HashMatrix(hash, camera.invRotation);
+	hash = HashWord(hash, GetRandomState());
+
+	return hash;
+}
+
+uint32_t StateHash::HashScreen()
+{
+	const uint8_t* screenBuffer = Platform::GetScreenBuffer();
+	uint32_t hash = fnvOffsetBasis;
+
+	for (uint16_t n = 0; n < DISPLAY_WIDTH * DISPLAY_HEIGHT / 8; n++)
+	{
+		hash = HashByte(hash, screenBuffer[n]);
+	}
+	return hash;
+}
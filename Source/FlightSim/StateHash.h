@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+
+// FNV-1a hashes of the game state and screen, built the same way on every target so that
+// host and AVR runs of the same replay can be compared hash by hash. Values are hashed a
+// byte at a time, low byte first, so struct layout and endianness don't matter.
+
+class StateHash
+{
+public:
+	// camera position, angles, rotation and invRotation, and the Random() state
+	static uint32_t HashState();
+	// The whole screen buffer
+	static uint32_t HashScreen();
+};
@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "OpCounters.h"
+#include "HeadlessPlatform.h"
+#include "RenderHarness.h"
+#include "lodepng.h"
+
+// Renders a single pose and captures the work done per screen column and 8 pixel page.
+// Writes <prefix>.png with the frame on top followed by heatmaps of estimated cycles,
+// divides, texture fetches and pixel writes, and <prefix>.csv with the raw numbers.
+// Usage: CostHeatmap [-method NAME] [-pitch N] [-roll N] [-yaw N] [-alt N] [-o PREFIX]
+
+#if !OP_COUNTERS
+#error CostHeatmap requires OP_COUNTERS=1
+#endif
+
+constexpr int numPages = OpCounters::numPages;
+constexpr int numMaps = 4;
+constexpr int imageHeight = DISPLAY_HEIGHT * (numMaps + 1) + numMaps;
+
+struct CellWork
+{
+	uint32_t values[numMaps];
+};
+
+static CellWork GetCellWork(uint8_t column, uint8_t page)
+{
+	CellWork work;
+	work.values[0] = OpCounters::EstimateCellCycles(column, page);
+	work.values[1] = OpCounters::cellCounts[(int)OpCounter::QuickDivide][page][column];
+	work.values[2] = OpCounters::cellCounts[(int)OpCounter::ProgmemReadByte][page][column];
+	work.values[3] = OpCounters::cellCounts[(int)OpCounter::DitherWrite][page][column]
+		+ OpCounters::cellCounts[(int)OpCounter::PixelWrite][page][column]
+		+ OpCounters::cellCounts[(int)OpCounter::BlockWrite][page][column];
+	return work;
+}
+
+// Black -> red -> yellow -> white
+static void HeatColour(float t, uint8_t* outPixel)
+{
+	float r = t * 3.0f;
+	float g = t * 3.0f - 1.0f;
+	float b = t * 3.0f - 2.0f;
+	outPixel[0] = (uint8_t)(255 * (r < 0 ? 0 : r > 1 ? 1 : r));
+	outPixel[1] = (uint8_t)(255 * (g < 0 ? 0 : g > 1 ? 1 : g));
+	outPixel[2] = (uint8_t)(255 * (b < 0 ? 0 : b > 1 ? 1 : b));
+	outPixel[3] = 255;
+}
+
+static void WriteHeatmap(const std::string& prefix)
+{
+	std::vector<uint8_t> image(DISPLAY_WIDTH * imageHeight * 4, 128);
+	uint32_t maxValues[numMaps] = {};
+
+	for (int page = 0; page < numPages; page++)
+	{
+		for (int x = 0; x < DISPLAY_WIDTH; x++)
+		{
+			CellWork work = GetCellWork(x, page);
+			for (int m = 0; m < numMaps; m++)
+			{
+				if (work.values[m] > maxValues[m])
+					maxValues[m] = work.values[m];
+			}
+		}
+	}
+
+	for (int y = 0; y < DISPLAY_HEIGHT; y++)
+	{
+		for (int x = 0; x < DISPLAY_WIDTH; x++)
+		{
+			uint8_t* pixel = &image[(y * DISPLAY_WIDTH + x) * 4];
+			uint8_t colour = HeadlessPlatform::GetPixel(x, y) ? 255 : 0;
+			pixel[0] = pixel[1] = pixel[2] = colour;
+			pixel[3] = 255;
+
+			CellWork work = GetCellWork(x, y / 8);
+			for (int m = 0; m < numMaps; m++)
+			{
+				int outY = (m + 1) * (DISPLAY_HEIGHT + 1) + y;
+				float t = maxValues[m] ? (float)work.values[m] / maxValues[m] : 0.0f;
+				HeatColour(t, &image[(outY * DISPLAY_WIDTH + x) * 4]);
+			}
+		}
+	}
+
+	std::string imagePath = prefix + ".png";
+	unsigned error = lodepng::encode(imagePath, image, DISPLAY_WIDTH, imageHeight);
+	if (error)
+	{
+		printf("%s : encoder error %u: %s\n", imagePath.c_str(), error, lodepng_error_text(error));
+	}
+
+	std::string csvPath = prefix + ".csv";
+	FILE* fs = fopen(csvPath.c_str(), "w");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", csvPath.c_str());
+		return;
+	}
+
+	fprintf(fs, "column,page,cycles,divides,fetches,writes\n");
+	for (int page = 0; page < numPages; page++)
+	{
+		for (int x = 0; x < DISPLAY_WIDTH; x++)
+		{
+			CellWork work = GetCellWork(x, page);
+			fprintf(fs, "%d,%d,%u,%u,%u,%u\n", x, page, work.values[0], work.values[1], work.values[2], work.values[3]);
+		}
+	}
+	fclose(fs);
+
+	printf("Wrote %s and %s\n", imagePath.c_str(), csvPath.c_str());
+	printf("Maximum per cell: %u cycles, %u divides, %u fetches, %u writes\n", maxValues[0], maxValues[1], maxValues[2], maxValues[3]);
+}
+
+static void PrintSummary()
+{
+	printf("\nEstimated cycles per page:\n");
+	for (int page = 0; page < numPages; page++)
+	{
+		uint32_t total = 0;
+		for (int x = 0; x < DISPLAY_WIDTH; x++)
+		{
+			total += OpCounters::EstimateCellCycles(x, page);
+		}
+		printf("  Page %d: %8u\n", page, total);
+	}
+
+	uint32_t columnCycles[DISPLAY_WIDTH] = {};
+	int worstColumn = 0;
+	for (int x = 0; x < DISPLAY_WIDTH; x++)
+	{
+		for (int page = 0; page < numPages; page++)
+		{
+			columnCycles[x] += OpCounters::EstimateCellCycles(x, page);
+		}
+		if (columnCycles[x] > columnCycles[worstColumn])
+		{
+			worstColumn = x;
+		}
+	}
+	printf("Most expensive column: %d with %u cycles\n", worstColumn, columnCycles[worstColumn]);
+	printf("Total: %u cycles\n", OpCounters::EstimateCycles());
+}
+
+int main(int argc, char* argv[])
+{
+	const char* methodName = "Interp";
+	std::string prefix = "heatmap";
+	CameraPose pose = { 0, 0, 0, 75 };
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-method") && n + 1 < argc)
+			methodName = argv[++n];
+		else if (!strcmp(argv[n], "-pitch") && n + 1 < argc)
+			pose.pitch = (angle_t)atoi(argv[++n]);
+		else if (!strcmp(argv[n], "-roll") && n + 1 < argc)
+			pose.roll = (angle_t)atoi(argv[++n]);
+		else if (!strcmp(argv[n], "-yaw") && n + 1 < argc)
+			pose.yaw = (angle_t)atoi(argv[++n]);
+		else if (!strcmp(argv[n], "-alt") && n + 1 < argc)
+			pose.altitude = (int16_t)atoi(argv[++n]);
+		else if (!strcmp(argv[n], "-o") && n + 1 < argc)
+			prefix = argv[++n];
+		else
+		{
+			printf("Usage: %s [-method NAME] [-pitch N] [-roll N] [-yaw N] [-alt N] [-o PREFIX]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	const DrawMethod* method = nullptr;
+	for (const DrawMethod& candidate : DrawMethods)
+	{
+		if (!strcmp(candidate.name, methodName))
+			method = &candidate;
+	}
+	if (!method)
+	{
+		printf("Unknown draw method %s\n", methodName);
+		return 1;
+	}
+
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+
+	ApplyPose(pose);
+	OpCounters::Reset();
+	method->draw();
+
+	printf("%s at pitch=%d roll=%d yaw=%d alt=%d\n", method->name, pose.pitch, pose.roll, pose.yaw, pose.altitude);
+	WriteHeatmap(prefix);
+	PrintSummary();
+
+	return 0;
+}
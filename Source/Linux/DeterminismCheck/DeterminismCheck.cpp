@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "Replay.h"
+#include "StateHash.h"
+#include "HeadlessPlatform.h"
+#include "DefaultReplay.h"
+
+// Plays a replay on the host the same way SimFirmware does, hashing the game state after every
+// tick and the screen after every draw, and compares the hashes with another run. The other
+// run is normally SimRunner -hashes on a SIM_HASHES firmware flying the same replay, but can
+// be a file written by -o from another host build. Only stages present in both are compared,
+// so a SIM_HASHES=1 firmware checks the state alone. Exits with 1 if any hash differs.
+// Usage: DeterminismCheck (-replay FILE | -default) [-compare HASHES] [-o HASHES]
+
+struct HostFrame
+{
+	uint32_t stateHash;
+	uint32_t screenHash;
+	Vector3s position;
+	angle_t pitch, roll, yaw;
+	uint16_t randomState;
+	uint8_t input;
+};
+
+static bool ReadHashes(const char* filename, std::map<std::pair<uint32_t, std::string>, uint32_t>& outHashes)
+{
+	FILE* fs = fopen(filename, "r");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", filename);
+		return false;
+	}
+
+	char line[128];
+	while (fgets(line, sizeof(line), fs))
+	{
+		unsigned frame, hash;
+		char stage[16];
+		if (line[0] == '#' || sscanf(line, "%u %15s %x", &frame, stage, &hash) != 3)
+			continue;
+		outHashes[std::make_pair((uint32_t)frame, std::string(stage))] = hash;
+	}
+
+	fclose(fs);
+	return true;
+}
+
+static void PrintFrame(const HostFrame& frame)
+{
+	printf("  host input=%u position=%d,%d,%d pitch=%d roll=%d yaw=%d random=%04x\n", frame.input,
+		frame.position.x.rawValue, frame.position.y.rawValue, frame.position.z.rawValue,
+		frame.pitch, frame.roll, frame.yaw, frame.randomState);
+}
+
+int main(int argc, char* argv[])
+{
+	const char* replayFilename = nullptr;
+	const char* compareFilename = nullptr;
+	const char* outputFilename = nullptr;
+	bool useDefault = false;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-replay") && n + 1 < argc)
+			replayFilename = argv[++n];
+		else if (!strcmp(argv[n], "-default"))
+			useDefault = true;
+		else if (!strcmp(argv[n], "-compare") && n + 1 < argc)
+			compareFilename = argv[++n];
+		else if (!strcmp(argv[n], "-o") && n + 1 < argc)
+			outputFilename = argv[++n];
+		else
+		{
+			replayFilename = nullptr;
+			useDefault = false;
+			break;
+		}
+	}
+
+	if (!replayFilename == !useDefault)
+	{
+		printf("Usage: %s (-replay FILE | -default) [-compare HASHES] [-o HASHES]\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<uint8_t> replay;
+	if (useDefault)
+	{
+		replay.assign(replayData, replayData + sizeof(replayData));
+	}
+	else if (!Replay::Load(replayFilename, replay))
+	{
+		return 1;
+	}
+
+	// Same order as SimFirmware
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+	if (!Replay::BeginPlayback(replay.data()))
+	{
+		printf("Not a version %d replay\n", Replay::version);
+		return 1;
+	}
+
+	std::vector<HostFrame> frames;
+	while (Replay::IsPlaying())
+	{
+		HostFrame frame;
+		frame.input = Replay::NextInput();
+		HeadlessPlatform::SetInput(frame.input);
+
+		Game::Tick();
+		frame.stateHash = StateHash::HashState();
+		frame.position = camera.position;
+		frame.pitch = camera.pitch;
+		frame.roll = camera.roll;
+		frame.yaw = camera.yaw;
+		frame.randomState = GetRandomState();
+
+		Game::Draw();
+		frame.screenHash = StateHash::HashScreen();
+
+		frames.push_back(frame);
+	}
+
+	printf("%d frames\n", (int)frames.size());
+
+	if (outputFilename)
+	{
+		FILE* fs = fopen(outputFilename, "w");
+		if (!fs)
+		{
+			printf("Failed to open %s\n", outputFilename);
+			return 1;
+		}
+		fprintf(fs, "# frame stage hash\n");
+		for (size_t n = 0; n < frames.size(); n++)
+		{
+			fprintf(fs, "%u state %08x\n", (unsigned)n, frames[n].stateHash);
+			fprintf(fs, "%u screen %08x\n", (unsigned)n, frames[n].screenHash);
+		}
+		fclose(fs);
+		printf("Wrote hashes to %s\n", outputFilename);
+	}
+
+	if (!compareFilename)
+	{
+		return 0;
+	}
+
+	std::map<std::pair<uint32_t, std::string>, uint32_t> otherHashes;
+	if (!ReadHashes(compareFilename, otherHashes))
+	{
+		return 1;
+	}
+
+	int numCompared = 0, numMismatched = 0;
+	for (size_t n = 0; n < frames.size(); n++)
+	{
+		const char* stages[] = { "state", "screen" };
+		uint32_t hostHashes[] = { frames[n].stateHash, frames[n].screenHash };
+
+		for (int stage = 0; stage < 2; stage++)
+		{
+			auto other = otherHashes.find(std::make_pair((uint32_t)n, std::string(stages[stage])));
+			if (other == otherHashes.end())
+				continue;
+
+			numCompared++;
+			if (other->second == hostHashes[stage])
+				continue;
+
+			// The first divergence is the interesting one, later frames follow from it
+			if (!numMismatched)
+			{
+				printf("First mismatch at frame %u %s: host %08x, %s %08x\n", (unsigned)n, stages[stage], hostHashes[stage], compareFilename, other->second);
+				PrintFrame(frames[n]);
+				if (n > 0)
+				{
+					printf("Previous frame\n");
+					PrintFrame(frames[n - 1]);
+				}
+			}
+			numMismatched++;
+		}
+	}
+
+	if (otherHashes.size() > (size_t)numCompared)
+	{
+		printf("%d hashes in %s have no host counterpart\n", (int)(otherHashes.size() - numCompared), compareFilename);
+	}
+	printf("%d hashes compared, %d mismatched\n", numCompared, numMismatched);
+	return numMismatched || !numCompared ? 1 : 0;
+}
@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include "Defines.h"
+#include "FixedMath.h"
+#include "Game.h"
+
+// Accuracy of FixedMath::QuickDivide against exact division.
+// Sweeps every fixed16_t numerator against every fixed8_t denominator, then reports the
+// texel error that results on the ground plane for each screen row of a level camera.
+// Usage: DivideAccuracy [-alt N] [-denominators] [-csv FILE]
+
+constexpr int textureShift = 4;					// World units per texel is 1 << textureShift
+constexpr int displayRows = DISPLAY_HEIGHT;
+constexpr angle_t cameraTilt = 4;				// Matches GameDrawInterp
+
+struct DenominatorStats
+{
+	int denom;
+	int recip;
+	double recipError;				// Relative error of the table entry itself
+	double maxAbsError;				// In raw fixed16_t units
+	double meanAbsError;
+	double maxRelError;
+	int overflows;					// Exact result doesn't fit in fixed16_t
+	int wraps;						// Exact result fits but the reciprocal rounding pushed it out of range
+};
+
+static DenominatorStats AnalyseDenominator(int denom)
+{
+	DenominatorStats stats = {};
+	stats.denom = denom;
+	stats.recip = pgm_read_word(&recipTable[(uint8_t)denom]);
+	stats.recipError = fabs(stats.recip - 1024.0 / denom) / (1024.0 / fabs((double)denom));
+
+	double totalAbsError = 0;
+	int numSamples = 0;
+
+	for (int x = INT16_MIN; x <= INT16_MAX; x++)
+	{
+		double exact = (double)x * (1 << FixedFractionalBits) / denom;
+		if (exact > INT16_MAX || exact < INT16_MIN)
+		{
+			stats.overflows++;
+			continue;
+		}
+
+		int16_t result = FixedMath::QuickDivide(fixed16_t::FromRaw((int16_t)x), fixed8_t::FromRaw((int8_t)denom)).rawValue;
+		double absError = fabs(result - exact);
+		if (absError > INT16_MAX)
+		{
+			stats.wraps++;
+			continue;
+		}
+
+		stats.maxAbsError = std::max(stats.maxAbsError, absError);
+		// Truncation dominates the relative error of tiny results, so only count results of at least 1.0
+		if (fabs(exact) >= (1 << FixedFractionalBits))
+		{
+			stats.maxRelError = std::max(stats.maxRelError, absError / fabs(exact));
+		}
+		totalAbsError += absError;
+		numSamples++;
+	}
+
+	stats.meanAbsError = numSamples ? totalAbsError / numSamples : 0;
+	return stats;
+}
+
+static void PrintDenominatorHeader()
+{
+	printf("%6s %6s %10s %10s %10s %10s %9s %6s\n", "denom", "recip", "recip err", "max abs", "mean abs", "max rel", "overflow", "wraps");
+}
+
+static void PrintDenominator(const DenominatorStats& stats)
+{
+	printf("%6d %6d %9.3f%% %10.2f %10.3f %9.3f%% %9d %6d\n", stats.denom, stats.recip, stats.recipError * 100.0,
+		stats.maxAbsError, stats.meanAbsError, stats.maxRelError * 100.0, stats.overflows, stats.wraps);
+}
+
+template <typename Filter>
+static void PrintSummary(const char* title, const std::vector<DenominatorStats>& allStats, Filter filter)
+{
+	int numPairs = 0, overflows = 0, wraps = 0;
+	double maxAbsError = 0, maxRelError = 0, totalMeanAbsError = 0;
+	int numDenominators = 0;
+
+	for (const DenominatorStats& stats : allStats)
+	{
+		if (filter(stats))
+		{
+			numDenominators++;
+			numPairs += 65536;
+			overflows += stats.overflows;
+			wraps += stats.wraps;
+			maxAbsError = std::max(maxAbsError, stats.maxAbsError);
+			maxRelError = std::max(maxRelError, stats.maxRelError);
+			totalMeanAbsError += stats.meanAbsError;
+		}
+	}
+
+	printf("%s (%d pairs)\n", title, numPairs);
+	printf("  Largest absolute error: %.2f (excluding overflows and wraps)\n", maxAbsError);
+	printf("  Mean absolute error:    %.3f\n", numDenominators ? totalMeanAbsError / numDenominators : 0.0);
+	printf("  Largest relative error: %.3f%%\n", maxRelError * 100.0);
+	printf("  Overflows:              %d (%.1f%%) where the exact result is out of fixed16_t range\n", overflows, 100.0 * overflows / numPairs);
+	printf("  Wraps:                  %d where the exact result fits but the rounded result doesn't\n", wraps);
+}
+
+// Ground intersection for the centre column of each row, with a level camera at the given altitude.
+// The divide error compares against exact division of the same fixed point view direction,
+// the total error compares against a double precision ray through the row.
+static void AnalyseGroundRows(int altitude)
+{
+	constexpr fixed8_t half = fixed8_t::FromRaw(1 << (FixedFractionalBits - 1));
+	constexpr fixed8_t groundThreshold = fixed8_t::FromRaw(-3);
+
+	Matrix3x3 cameraRotation = Matrix3x3::RotateX(cameraTilt) * Matrix3x3::Identity();
+	Vector3b viewDirTop = cameraRotation * Vector3b(0, half, 1);
+	Vector3b viewDirBottom = cameraRotation * Vector3b(0, -half, 1);
+
+	const double tilt = FIXED_ANGLE_TO_RADIANS(cameraTilt);
+	const double texelSize = 1 << textureShift;
+	const fixed16_t cameraY = altitude;
+
+	printf("\nGround texel error per row, level camera at altitude %d\n", altitude);
+	printf("%4s %6s %6s %10s %10s %11s %11s\n", "row", "dir.y", "denom", "distance", "exact", "divide err", "total err");
+
+	double maxDivideError = 0, maxTotalError = 0;
+
+	for (int row = 0; row < displayRows; row++)
+	{
+		Vector3b worldDir = Lerp(viewDirTop, viewDirBottom, fixed8_t::FromRaw(row));
+		if (worldDir.y.rawValue >= 0)
+		{
+			printf("%4d %6d %6s %10s\n", row, worldDir.y.rawValue, "-", "sky");
+			continue;
+		}
+
+		fixed8_t denom = -worldDir.y;
+		fixed16_t distance = FixedMath::QuickDivide(cameraY, denom);
+		fixed16_t intersectionZ = worldDir.z * distance;
+
+		double dirY = worldDir.y.rawValue / 64.0;
+		double dirZ = worldDir.z.rawValue / 64.0;
+		double exactDistance = altitude / -dirY;
+		bool overflow = exactDistance * 64.0 > INT16_MAX;
+
+		// Double precision ray through the same row, before any quantisation
+		double viewY = 0.5 - row / 64.0;
+		double rayY = viewY * cos(tilt) - sin(tilt);
+		double rayZ = viewY * sin(tilt) + cos(tilt);
+
+		double divideError = fabs(intersectionZ.rawValue / 64.0 - dirZ * exactDistance) / texelSize;
+		double totalError = rayY < 0 ? fabs(intersectionZ.rawValue / 64.0 - rayZ * altitude / -rayY) / texelSize : INFINITY;
+
+		const char* note = overflow ? " overflow" : worldDir.y >= groundThreshold ? " untextured" : "";
+		printf("%4d %6d %6d %10.2f %10.2f %11.2f %11.2f%s\n", row, worldDir.y.rawValue, denom.rawValue,
+			distance.rawValue / 64.0, exactDistance, divideError, totalError, note);
+
+		if (!overflow && worldDir.y < groundThreshold)
+		{
+			maxDivideError = std::max(maxDivideError, divideError);
+			maxTotalError = std::max(maxTotalError, totalError);
+		}
+	}
+
+	printf("Largest error on textured rows: %.2f texels from the divide, %.2f texels in total\n", maxDivideError, maxTotalError);
+}
+
+int main(int argc, char* argv[])
+{
+	int altitude = 75;
+	bool printAllDenominators = false;
+	const char* csvFilename = nullptr;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-alt") && n + 1 < argc)
+		{
+			altitude = atoi(argv[++n]);
+		}
+		else if (!strcmp(argv[n], "-denominators"))
+		{
+			printAllDenominators = true;
+		}
+		else if (!strcmp(argv[n], "-csv") && n + 1 < argc)
+		{
+			csvFilename = argv[++n];
+		}
+		else
+		{
+			printf("Usage: %s [-alt N] [-denominators] [-csv FILE]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<DenominatorStats> allStats;
+
+	for (int denom = INT8_MIN; denom <= INT8_MAX; denom++)
+	{
+		if (denom != 0)
+		{
+			allStats.push_back(AnalyseDenominator(denom));
+		}
+	}
+
+	// Division by zero isn't trapped: recipTable[0] is 0 so every numerator gives 0
+	int zeroDenomNonZero = 0;
+	for (int x = INT16_MIN; x <= INT16_MAX; x++)
+	{
+		if (FixedMath::QuickDivide(fixed16_t::FromRaw((int16_t)x), fixed8_t::FromRaw(0)).rawValue != 0)
+			zeroDenomNonZero++;
+	}
+
+	printf("QuickDivide over every fixed16_t numerator (errors in raw fixed16_t units)\n");
+	PrintSummary("Positive denominators", allStats, [](const DenominatorStats& stats) { return stats.denom > 0; });
+	// pgm_read_word zero extends, so the negative table entries are used as large positive values
+	PrintSummary("Negative denominators", allStats, [](const DenominatorStats& stats) { return stats.denom < 0; });
+	printf("Denominator 0\n  Returns 0 for %d of 65536 numerators\n", 65536 - zeroDenomNonZero);
+
+	printf("\n");
+	PrintDenominatorHeader();
+	if (printAllDenominators)
+	{
+		for (const DenominatorStats& stats : allStats)
+		{
+			PrintDenominator(stats);
+		}
+	}
+	else
+	{
+		// Just the least accurate of the positive denominators, which are the ones the renderers use
+		std::vector<DenominatorStats> sorted;
+		std::copy_if(allStats.begin(), allStats.end(), std::back_inserter(sorted), [](const DenominatorStats& stats) { return stats.denom > 0; });
+		std::sort(sorted.begin(), sorted.end(), [](const DenominatorStats& a, const DenominatorStats& b) { return a.maxRelError > b.maxRelError; });
+		for (int n = 0; n < 10; n++)
+		{
+			PrintDenominator(sorted[n]);
+		}
+		printf("(worst 10 positive denominators by relative error, use -denominators for all)\n");
+	}
+
+	if (csvFilename)
+	{
+		FILE* fs = fopen(csvFilename, "w");
+		if (!fs)
+		{
+			printf("Failed to open %s\n", csvFilename);
+			return 1;
+		}
+		fprintf(fs, "denom,recip,recip_error,max_abs_error,mean_abs_error,max_rel_error,overflows,wraps\n");
+		for (const DenominatorStats& stats : allStats)
+		{
+			fprintf(fs, "%d,%d,%f,%f,%f,%f,%d,%d\n", stats.denom, stats.recip, stats.recipError,
+				stats.maxAbsError, stats.meanAbsError, stats.maxRelError, stats.overflows, stats.wraps);
+		}
+		fclose(fs);
+	}
+
+	AnalyseGroundRows(altitude);
+
+	return 0;
+}
@@ -0,0 +1,267 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "Defines.h"
+#include "FixedMath.h"
+
+// Host throughput of each FixedMath primitive, in ns per call.
+// Chained runs feed each result into the next call so measure latency, independent runs
+// use a fresh input every call so measure throughput.
+// Usage: FixedMathBench [-iterations N] [-reps N] [-filter NAME]
+
+constexpr int numInputs = 1024;
+constexpr int inputMask = numInputs - 1;
+
+static int iterations = 1 << 20;
+static int reps = 5;
+static const char* filter = nullptr;
+
+static fixed8_t inputs8[numInputs];
+static fixed8_t nonZeroInputs8[numInputs];
+static fixed16_t inputs16[numInputs];
+static fixed16_t nonZeroInputs16[numInputs];
+static int smallInts[numInputs];
+static angle_t angles[numInputs];
+static Matrix3x3 rotations[numInputs];
+static Vector3b vectors8[numInputs];
+static Vector3s vectors16[numInputs];
+
+// Compiler barriers so that results can't be folded away or vectorised across iterations.
+// Chain() also forces the value through a register / memory between iterations.
+template <typename T>
+inline void Use(const T& value) { asm volatile("" : : "m"(value)); }
+inline void Use(fixed8_t value) { asm volatile("" : : "r"(value.rawValue)); }
+inline void Use(fixed16_t value) { asm volatile("" : : "r"(value.rawValue)); }
+inline void Use(uint16_t value) { asm volatile("" : : "r"(value)); }
+
+template <typename T>
+inline void Chain(T& value) { asm volatile("" : "+m"(value)); }
+inline void Chain(fixed8_t& value) { asm volatile("" : "+r"(value.rawValue)); }
+inline void Chain(fixed16_t& value) { asm volatile("" : "+r"(value.rawValue)); }
+inline void Chain(uint16_t& value) { asm volatile("" : "+r"(value)); }
+
+// Best of reps, in ns per iteration
+template <typename Body>
+double TimeLoop(Body body)
+{
+	double best = 0;
+
+	for (int rep = 0; rep < reps; rep++)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		body();
+		auto endTime = std::chrono::steady_clock::now();
+
+		double elapsed = std::chrono::duration<double, std::nano>(endTime - startTime).count();
+		if (rep == 0 || elapsed < best)
+		{
+			best = elapsed;
+		}
+	}
+
+	return best / iterations;
+}
+
+template <typename T, typename Op>
+double BenchChained(T start, Op op)
+{
+	return TimeLoop([&]()
+	{
+		T value = start;
+		for (int n = 0; n < iterations; n++)
+		{
+			value = op(value, n & inputMask);
+			Chain(value);
+		}
+		Use(value);
+	});
+}
+
+template <typename Op>
+double BenchIndependent(Op op)
+{
+	return TimeLoop([&]()
+	{
+		for (int n = 0; n < iterations; n++)
+		{
+			auto result = op(n & inputMask);
+			Use(result);
+		}
+	});
+}
+
+static bool ShouldRun(const char* name)
+{
+	return !filter || strstr(name, filter);
+}
+
+template <typename T, typename ChainedOp, typename IndependentOp>
+void Bench(const char* name, T start, ChainedOp chainedOp, IndependentOp independentOp)
+{
+	if (ShouldRun(name))
+	{
+		double chained = BenchChained(start, chainedOp);
+		double independent = BenchIndependent(independentOp);
+		printf("%-28s %10.2f %12.2f\n", name, chained, independent);
+	}
+}
+
+template <typename T, typename ChainedOp>
+void BenchChainedOnly(const char* name, T start, ChainedOp chainedOp)
+{
+	if (ShouldRun(name))
+	{
+		printf("%-28s %10.2f %12s\n", name, BenchChained(start, chainedOp), "-");
+	}
+}
+
+static void GenerateInputs()
+{
+	srand(1234);
+
+	for (int n = 0; n < numInputs; n++)
+	{
+		inputs8[n] = fixed8_t::FromRaw((int8_t)rand());
+		inputs16[n] = fixed16_t::FromRaw((int16_t)rand());
+
+		int8_t nonZero8 = (int8_t)rand();
+		nonZeroInputs8[n] = fixed8_t::FromRaw(nonZero8 ? nonZero8 : 1);
+		int16_t nonZero16 = (int16_t)rand();
+		nonZeroInputs16[n] = fixed16_t::FromRaw(nonZero16 ? nonZero16 : 1);
+		smallInts[n] = 1 + rand() % 15;
+
+		angles[n] = (angle_t)rand();
+		rotations[n] = Matrix3x3::RotateZ((angle_t)rand()) * Matrix3x3::RotateX((angle_t)rand()) * Matrix3x3::RotateY((angle_t)rand());
+
+		// Keep vectors roughly unit length so that products stay in range
+		vectors8[n] = Vector3b(fixed8_t::FromRaw((int8_t)(rand() % 64 - 32)), fixed8_t::FromRaw((int8_t)(rand() % 64 - 32)), fixed8_t::FromRaw((int8_t)(rand() % 64 - 32)));
+		vectors16[n] = Vector3s(fixed16_t::FromRaw((int16_t)(rand() % 4096 - 2048)), fixed16_t::FromRaw((int16_t)(rand() % 4096 - 2048)), fixed16_t::FromRaw((int16_t)(rand() % 4096 - 2048)));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-iterations") && n + 1 < argc)
+		{
+			iterations = atoi(argv[++n]);
+		}
+		else if (!strcmp(argv[n], "-reps") && n + 1 < argc)
+		{
+			reps = atoi(argv[++n]);
+		}
+		else if (!strcmp(argv[n], "-filter") && n + 1 < argc)
+		{
+			filter = argv[++n];
+		}
+		else
+		{
+			printf("Usage: %s [-iterations N] [-reps N] [-filter NAME]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (iterations <= 0 || reps <= 0)
+	{
+		printf("Iterations and reps must be positive\n");
+		return 1;
+	}
+
+	GenerateInputs();
+
+	const fixed8_t one8 = 1;
+	const fixed16_t one16 = 1;
+	const Vector3b unit8(0, 0, 1);
+	const Vector3s unit16(0, 0, 1);
+	const Matrix3x3 identity = Matrix3x3::Identity();
+
+	printf("%d iterations, best of %d\n\n", iterations, reps);
+	printf("%-28s %10s %12s\n", "ns per call", "chained", "independent");
+
+	Bench("loop overhead", one8,
+		[](fixed8_t x, int) { return x; },
+		[](int n) { return inputs8[n]; });
+
+	Bench("fixed8_t +", one8,
+		[](fixed8_t x, int n) { return x + inputs8[n]; },
+		[](int n) { return inputs8[n] + inputs8[n ^ 1]; });
+	Bench("fixed8_t -", one8,
+		[](fixed8_t x, int n) { return x - inputs8[n]; },
+		[](int n) { return inputs8[n] - inputs8[n ^ 1]; });
+	Bench("fixed8_t *", one8,
+		[](fixed8_t x, int n) { return x * inputs8[n]; },
+		[](int n) { return inputs8[n] * inputs8[n ^ 1]; });
+	Bench("fixed8_t /", one8,
+		[](fixed8_t x, int n) { return x / nonZeroInputs8[n]; },
+		[](int n) { return inputs8[n] / nonZeroInputs8[n ^ 1]; });
+
+	Bench("fixed16_t +", one16,
+		[](fixed16_t x, int n) { return x + inputs16[n]; },
+		[](int n) { return inputs16[n] + inputs16[n ^ 1]; });
+	Bench("fixed16_t -", one16,
+		[](fixed16_t x, int n) { return x - inputs16[n]; },
+		[](int n) { return inputs16[n] - inputs16[n ^ 1]; });
+	Bench("fixed16_t *", one16,
+		[](fixed16_t x, int n) { return x * inputs16[n]; },
+		[](int n) { return inputs16[n] * inputs16[n ^ 1]; });
+	Bench("fixed16_t * int", one16,
+		[](fixed16_t x, int n) { return x * smallInts[n]; },
+		[](int n) { return inputs16[n] * smallInts[n ^ 1]; });
+	Bench("fixed16_t /", one16,
+		[](fixed16_t x, int n) { return x / nonZeroInputs16[n]; },
+		[](int n) { return inputs16[n] / nonZeroInputs16[n ^ 1]; });
+	Bench("fixed16_t / int", one16,
+		[](fixed16_t x, int n) { return x / smallInts[n]; },
+		[](int n) { return inputs16[n] / smallInts[n ^ 1]; });
+
+	Bench("FixedMath::QuickDivide", one16,
+		[](fixed16_t x, int n) { return FixedMath::QuickDivide(x, inputs8[n]); },
+		[](int n) { return FixedMath::QuickDivide(inputs16[n], inputs8[n ^ 1]); });
+	Bench("FixedMath::Sin", one8,
+		[](fixed8_t x, int n) { return FixedMath::Sin((angle_t)(x.rawValue + angles[n])); },
+		[](int n) { return FixedMath::Sin(angles[n]); });
+	Bench("FixedMath::Cos", one8,
+		[](fixed8_t x, int n) { return FixedMath::Cos((angle_t)(x.rawValue + angles[n])); },
+		[](int n) { return FixedMath::Cos(angles[n]); });
+
+	Bench("Matrix3x3 * Matrix3x3", identity,
+		[](Matrix3x3 m, int n) { return m * rotations[n]; },
+		[](int n) { return rotations[n] * rotations[n ^ 1]; });
+	Bench("Matrix3x3 * Vector3b", unit8,
+		[](Vector3b v, int n) { return rotations[n] * v; },
+		[](int n) { return rotations[n] * vectors8[n ^ 1]; });
+	Bench("Matrix3x3 * Vector3s", unit16,
+		[](Vector3s v, int n) { return rotations[n] * v; },
+		[](int n) { return rotations[n] * vectors16[n ^ 1]; });
+	Bench("Matrix3x3::Transpose", identity,
+		[](Matrix3x3 m, int) { return m.Transpose(); },
+		[](int n) { return rotations[n].Transpose(); });
+	Bench("Matrix3x3::Normalize", identity,
+		[](Matrix3x3 m, int) { m.Normalize(); return m; },
+		[](int n) { Matrix3x3 m = rotations[n]; m.Normalize(); return m; });
+	Bench("Matrix3x3::RotateX", identity,
+		[](Matrix3x3 m, int n) { return Matrix3x3::RotateX((angle_t)(m.m[0][1].rawValue + angles[n])); },
+		[](int n) { return Matrix3x3::RotateX(angles[n]); });
+
+	Bench("Vector3b::Normalize", unit8,
+		[](Vector3b v, int) { v.Normalize(); return v; },
+		[](int n) { Vector3b v = vectors8[n]; v.Normalize(); return v; });
+	Bench("Vector3s::Normalize", unit16,
+		[](Vector3s v, int) { v.Normalize(); return v; },
+		[](int n) { Vector3s v = vectors16[n]; v.Normalize(); return v; });
+	Bench("Vector3b::Cross", unit8,
+		[](Vector3b v, int n) { return Vector3b(v.Cross(vectors8[n])); },
+		[](int n) { return Vector3b(vectors8[n].Cross(vectors8[n ^ 1])); });
+	Bench("Vector3s::Cross", unit16,
+		[](Vector3s v, int n) { return Vector3s(v.Cross(vectors16[n])); },
+		[](int n) { return Vector3s(vectors16[n].Cross(vectors16[n ^ 1])); });
+
+	// The generator state is itself a dependency chain so there is no independent variant
+	SeedRandom(1);
+	BenchChainedOnly("Random", (uint16_t)0,
+		[](uint16_t x, int) { return (uint16_t)(x + Random()); });
+
+	return 0;
+}
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "FlightPath.h"
+#include "Game.h"
+
+static Keyframe MakeKeyframe(int frame, int x, int y, int z, int pitch, int roll, int yaw)
+{
+	constexpr int32_t rawScale = 64;
+	return Keyframe { frame, x * rawScale, y * rawScale, z * rawScale, pitch, roll, yaw };
+}
+
+static int32_t Interpolate(int32_t a, int32_t b, int t, int span)
+{
+	return a + (int32_t)((int64_t)(b - a) * t / span);
+}
+
+static std::vector<FlightPath> BuildBuiltInPaths()
+{
+	std::vector<FlightPath> paths;
+
+	// Circling just above the ground with a steady bank
+	paths.push_back({ "banked-turn", {
+		MakeKeyframe(0, 0, 4, 0, 0, 32, 0),
+		MakeKeyframe(60, 38, 3, 38, 0, 40, 64),
+		MakeKeyframe(120, 0, 2, 76, 4, 40, 128),
+		MakeKeyframe(180, -38, 3, 38, 0, 40, 192),
+		MakeKeyframe(240, 0, 4, 0, 0, 32, 256),
+	} });
+
+	// Upside down between the ground and clouds, where GameDrawInterp reverses its region order
+	paths.push_back({ "inverted", {
+		MakeKeyframe(0, 0, 60, 0, 0, 128, 0),
+		MakeKeyframe(60, 0, 60, 60, 16, 128, 16),
+		MakeKeyframe(120, 0, 40, 120, -16, 136, 32),
+		MakeKeyframe(180, 0, 60, 180, 0, 120, 32),
+	} });
+
+	// Wings vertical, where the top and bottom of every column look at the same height
+	paths.push_back({ "knife-edge", {
+		MakeKeyframe(0, 0, 30, 0, 0, 64, 0),
+		MakeKeyframe(90, 60, 30, 60, 0, 64, 64),
+		MakeKeyframe(120, 80, 30, 60, 0, 192, 64),
+		MakeKeyframe(210, 140, 30, 0, 0, 192, 0),
+	} });
+
+	// Pull up from the ground to the cloud layer, then dive back down
+	paths.push_back({ "steep-climb", {
+		MakeKeyframe(0, 0, 5, 0, 0, 0, 0),
+		MakeKeyframe(30, 0, 10, 28, 48, 0, 0),
+		MakeKeyframe(150, 0, 115, 88, 48, 0, 0),
+		MakeKeyframe(180, 0, 120, 116, 0, 0, 0),
+		MakeKeyframe(210, 0, 115, 144, -48, 0, 0),
+		MakeKeyframe(330, 0, 5, 204, -48, 0, 0),
+		MakeKeyframe(360, 0, 5, 232, 0, 0, 0),
+	} });
+
+	// Every roll angle at a moderate altitude
+	paths.push_back({ "barrel-roll", {
+		MakeKeyframe(0, 0, 40, 0, 0, 0, 0),
+		MakeKeyframe(60, 0, 48, 60, 12, 128, 8),
+		MakeKeyframe(120, 0, 40, 120, 0, 256, 16),
+	} });
+
+	return paths;
+}
+
+int FlightPath::GetNumFrames() const
+{
+	return keyframes.empty() ? 0 : keyframes.back().frame + 1;
+}
+
+void FlightPath::Apply(int frame) const
+{
+	if (keyframes.empty())
+	{
+		return;
+	}
+
+	// Last keyframe at or before the frame
+	size_t index = 0;
+	while (index + 1 < keyframes.size() && keyframes[index + 1].frame <= frame)
+	{
+		index++;
+	}
+
+	const Keyframe& from = keyframes[index];
+	const Keyframe& to = index + 1 < keyframes.size() ? keyframes[index + 1] : from;
+	int span = to.frame - from.frame;
+	int t = frame < from.frame ? 0 : frame - from.frame;
+	if (span <= 0)
+	{
+		span = 1;
+		t = 0;
+	}
+
+	camera.position.x = fixed16_t::FromRaw((int16_t)Interpolate(from.x, to.x, t, span));
+	camera.position.y = fixed16_t::FromRaw((int16_t)Interpolate(from.y, to.y, t, span));
+	camera.position.z = fixed16_t::FromRaw((int16_t)Interpolate(from.z, to.z, t, span));
+	camera.pitch = (angle_t)Interpolate(from.pitch, to.pitch, t, span);
+	camera.roll = (angle_t)Interpolate(from.roll, to.roll, t, span);
+	camera.yaw = (angle_t)Interpolate(from.yaw, to.yaw, t, span);
+	camera.UpdateRotation();
+}
+
+const std::vector<FlightPath>& FlightPath::GetBuiltIn()
+{
+	static const std::vector<FlightPath> paths = BuildBuiltInPaths();
+	return paths;
+}
+
+const FlightPath* FlightPath::FindBuiltIn(const char* name)
+{
+	for (const FlightPath& path : GetBuiltIn())
+	{
+		if (!strcmp(path.name, name))
+			return &path;
+	}
+	return nullptr;
+}
+
+bool FlightPath::Load(const char* filename, FlightPath& outPath)
+{
+	FILE* fs = fopen(filename, "r");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", filename);
+		return false;
+	}
+
+	outPath.name = filename;
+	outPath.keyframes.clear();
+
+	char line[256];
+	int lineNumber = 0;
+	bool success = true;
+
+	while (success && fgets(line, sizeof(line), fs))
+	{
+		lineNumber++;
+
+		char* comment = strchr(line, '#');
+		if (comment)
+			*comment = '\0';
+
+		int frame, pitch, roll, yaw;
+		double x, y, z;
+		int numRead = sscanf(line, "%d %lf %lf %lf %d %d %d", &frame, &x, &y, &z, &pitch, &roll, &yaw);
+		if (numRead <= 0)
+			continue;
+
+		if (numRead != 7)
+		{
+			printf("%s(%d): expected frame x y z pitch roll yaw\n", filename, lineNumber);
+			success = false;
+		}
+		else if (!outPath.keyframes.empty() && frame <= outPath.keyframes.back().frame)
+		{
+			printf("%s(%d): keyframes must be in increasing frame order\n", filename, lineNumber);
+			success = false;
+		}
+		else
+		{
+			Keyframe keyframe = { frame, (int32_t)lround(x * 64), (int32_t)lround(y * 64), (int32_t)lround(z * 64), pitch, roll, yaw };
+			outPath.keyframes.push_back(keyframe);
+		}
+	}
+
+	fclose(fs);
+
+	if (success && outPath.keyframes.empty())
+	{
+		printf("%s has no keyframes\n", filename);
+		success = false;
+	}
+	return success;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "Defines.h"
+
+// Benchmark flights described as camera keyframes rather than input, so the frames drawn
+// don't depend on Game::Tick's control law. Host runners call Apply before Game::Draw
+// instead of ticking. Interpolation is linear and integer only, so every host draws the
+// same frames.
+//
+// Keyframe files are text, one keyframe per line, # for comments:
+//   frame x y z pitch roll yaw
+// Positions are in world units and angles in FIXED_ANGLE_MAX units. Angles aren't wrapped
+// so 0 to 256 is a full turn rather than none.
+
+struct Keyframe
+{
+	int frame;
+	int32_t x, y, z;			// raw fixed16_t, wrapped when applied
+	int pitch, roll, yaw;
+};
+
+struct FlightPath
+{
+	const char* name;
+	std::vector<Keyframe> keyframes;
+
+	int GetNumFrames() const;
+
+	// Sets camera position and angles for the frame, holding the last keyframe past the end
+	void Apply(int frame) const;
+
+	// Built in paths covering the expensive and unusual cases of the renderers
+	static const std::vector<FlightPath>& GetBuiltIn();
+	static const FlightPath* FindBuiltIn(const char* name);
+
+	static bool Load(const char* filename, FlightPath& outPath);
+};
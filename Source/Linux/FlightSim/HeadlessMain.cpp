@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "HeadlessPlatform.h"
+#include "FlightPath.h"
+#include "TraceRecorder.h"
+#include "StateHash.h"
+
+// Runs the game loop without a display as fast as possible.
+// Usage: FlightSimHeadless [-frames N] [-input MASK] [-replay FILE] [-record FILE] [-path NAME|FILE]
+// -replay plays back an input replay, by default for its full length, and -record saves the run as one.
+// -path flies a built in or keyframe file FlightPath instead of ticking the game.
+// Profiler builds can also export the run with [-trace FILE.json] [-csv FILE.csv] [-tracebuffer EVENTS]
+// FIXED_OVERFLOW_CHECKS builds report fixed point overflows by call site
+
+int main(int argc, char* argv[])
+{
+	int numFrames = 1000;
+	bool hasNumFrames = false;
+	uint8_t inputMask = 0;
+	const char* replayFilename = nullptr;
+	const char* recordFilename = nullptr;
+	const char* pathName = nullptr;
+#if PROFILER
+	const char* traceFilename = nullptr;
+	const char* csvFilename = nullptr;
+	uint32_t traceBufferSize = TraceRecorder::defaultMaxEvents;
+#endif
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-frames") && n + 1 < argc)
+		{
+			numFrames = atoi(argv[++n]);
+			hasNumFrames = true;
+		}
+		else if (!strcmp(argv[n], "-input") && n + 1 < argc)
+		{
+			inputMask = (uint8_t)strtol(argv[++n], nullptr, 0);
+		}
+		else if (!strcmp(argv[n], "-replay") && n + 1 < argc)
+		{
+			replayFilename = argv[++n];
+		}
+		else if (!strcmp(argv[n], "-record") && n + 1 < argc)
+		{
+			recordFilename = argv[++n];
+		}
+		else if (!strcmp(argv[n], "-path") && n + 1 < argc)
+		{
+			pathName = argv[++n];
+		}
+#if PROFILER
+		else if (!strcmp(argv[n], "-trace") && n + 1 < argc)
+		{
+			traceFilename = argv[++n];
+		}
+		else if (!strcmp(argv[n], "-csv") && n + 1 < argc)
+		{
+			csvFilename = argv[++n];
+		}
+		else if (!strcmp(argv[n], "-tracebuffer") && n + 1 < argc)
+		{
+			traceBufferSize = (uint32_t)strtoul(argv[++n], nullptr, 0);
+		}
+#endif
+		else
+		{
+			printf("Usage: %s [-frames N] [-input MASK] [-replay FILE] [-record FILE] [-path NAME|FILE]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	constexpr uint16_t seed = 0;
+	SeedRandom(seed);
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+
+	HeadlessPlatform::SetInput(inputMask);
+
+	std::vector<uint8_t> replay;
+	if (replayFilename)
+	{
+		if (!Replay::Load(replayFilename, replay) || !Replay::BeginPlayback(replay.data()))
+		{
+			printf("Failed to play back %s\n", replayFilename);
+			return 1;
+		}
+		if (!hasNumFrames)
+		{
+			numFrames = (int)Replay::GetNumTicks(replay.data());
+		}
+	}
+
+	if (recordFilename)
+	{
+		Replay::BeginRecording(seed);
+	}
+
+	FlightPath loadedPath;
+	const FlightPath* path = nullptr;
+	if (pathName)
+	{
+		path = FlightPath::FindBuiltIn(pathName);
+		if (!path)
+		{
+			if (!FlightPath::Load(pathName, loadedPath))
+				return 1;
+			path = &loadedPath;
+		}
+		if (!hasNumFrames)
+		{
+			numFrames = path->GetNumFrames();
+		}
+	}
+
+#if PROFILER
+	uint64_t zoneTotals[(int)ProfileZone::NumZones] = {};
+
+	bool tracing = (traceFilename || csvFilename) && traceBufferSize > 0;
+	if (tracing)
+	{
+		TraceRecorder::Start(traceBufferSize);
+	}
+#endif
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	for (int frame = 0; frame < numFrames; frame++)
+	{
+#if PROFILER
+		Profiler::BeginFrame();
+		if (tracing)
+		{
+			TraceRecorder::BeginFrame();
+		}
+#endif
+
+		// Falls back to -input once the replay runs out
+		if (replayFilename)
+		{
+			HeadlessPlatform::SetInput(Replay::IsPlaying() ? Replay::NextInput() : inputMask);
+		}
+		Replay::RecordInput(Platform::GetInput());
+
+		if (path)
+		{
+			path->Apply(frame);
+		}
+		else
+		{
+			Game::Tick();
+		}
+		Game::Draw();
+
+#if PROFILER
+		if (tracing)
+		{
+			TraceRecorder::EndFrame();
+		}
+
+		for (int n = 0; n < (int)ProfileZone::NumZones; n++)
+		{
+			zoneTotals[n] += Profiler::zoneTimes[n];
+		}
+#endif
+	}
+
+	auto endTime = std::chrono::steady_clock::now();
+	double elapsedMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+	printf("Frames:     %d\n", numFrames);
+	printf("Total time: %.3f ms\n", elapsedMs);
+	if (numFrames > 0)
+	{
+		printf("Per frame:  %.3f us\n", 1000.0 * elapsedMs / numFrames);
+	}
+	printf("Frame hash: %08x\n", StateHash::HashScreen());
+
+	if (recordFilename && Replay::Save(recordFilename, Replay::EndRecording()))
+	{
+		printf("Wrote replay to %s\n", recordFilename);
+	}
+
+#if FIXED_OVERFLOW_CHECKS
+	printf("\n");
+	FixedOverflow::Print(numFrames);
+#endif
+
+#if PROFILER
+	if (numFrames > 0)
+	{
+		printf("\nMean zone time per frame:\n");
+		for (int n = 0; n < (int)ProfileZone::NumZones; n++)
+		{
+			printf("  %-14s %10.0f %s\n", Profiler::GetZoneName((ProfileZone)n), (double)zoneTotals[n] / numFrames, Profiler::timeUnit);
+		}
+	}
+
+	if (tracing)
+	{
+		TraceRecorder::Stop();
+
+		if (TraceRecorder::GetDroppedEvents() || TraceRecorder::GetDroppedFrames())
+		{
+			printf("\nTrace buffer full: dropped the oldest %u events and %u frames\n", TraceRecorder::GetDroppedEvents(), TraceRecorder::GetDroppedFrames());
+		}
+		if (traceFilename && TraceRecorder::WriteChromeTrace(traceFilename))
+		{
+			printf("Wrote trace to %s\n", traceFilename);
+		}
+		if (csvFilename && TraceRecorder::WriteFrameCsv(csvFilename))
+		{
+			printf("Wrote frame metrics to %s\n", csvFilename);
+		}
+	}
+#endif
+
+	return 0;
+}
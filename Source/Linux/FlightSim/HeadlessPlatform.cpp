@@ -0,0 +1,275 @@
+#include <stdlib.h>
+#include <string.h>
+#include "Defines.h"
+#include "Platform.h"
+#include "HeadlessPlatform.h"
+
+uint8_t sBuffer[DISPLAY_WIDTH * DISPLAY_HEIGHT / 8];
+
+static uint8_t InputMask = 0;
+static bool isAudioEnabled = false;
+
+static void swap(int16_t& a, int16_t& b)
+{
+	int16_t temp = a;
+	a = b;
+	b = temp;
+}
+
+void HeadlessPlatform::SetInput(uint8_t inputMask)
+{
+	InputMask = inputMask;
+}
+
+uint8_t HeadlessPlatform::GetPixel(uint8_t x, uint8_t y)
+{
+	uint8_t row = y / 8;
+	uint8_t bit_position = y % 8;
+	return (sBuffer[(row*DISPLAY_WIDTH) + x] & (1 << bit_position)) >> bit_position;
+}
+
+void HeadlessPlatform::ClearScreen()
+{
+	memset(sBuffer, 0, sizeof(sBuffer));
+}
+
+uint8_t Platform::GetInput()
+{
+	return InputMask;
+}
+
+uint8_t* Platform::GetScreenBuffer()
+{
+	return sBuffer;
+}
+
+void Platform::SetLED(uint8_t, uint8_t, uint8_t)
+{
+
+}
+
+void Platform::PlaySound(const uint16_t*)
+{
+
+}
+
+bool Platform::IsAudioEnabled()
+{
+	return isAudioEnabled;
+}
+
+void Platform::SetAudioEnabled(bool isEnabled)
+{
+	isAudioEnabled = isEnabled;
+}
+
+void Platform::ExpectLoadDelay()
+{
+
+}
+
+void Platform::PutPixel(uint8_t x, uint8_t y, uint8_t colour)
+{
+	if (x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT)
+	{
+		return;
+	}
+
+	uint16_t row_offset;
+	uint8_t bit;
+
+	bit = 1 << (y & 7);
+	row_offset = (y & 0xF8) * DISPLAY_WIDTH / 8 + x;
+	uint8_t data = sBuffer[row_offset] | bit;
+	if (!colour) data ^= bit;
+	sBuffer[row_offset] = data;
+}
+
+void Platform::FillScreen(uint8_t colour)
+{
+	memset(sBuffer, colour ? 0xff : 0, sizeof(sBuffer));
+}
+
+void Platform::FillRect(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t colour)
+{
+	if (x1 < 0)
+		x1 = 0;
+	if (x2 >= DISPLAY_WIDTH)
+		x2 = DISPLAY_WIDTH - 1;
+	if (y1 < 0)
+		y1 = 0;
+	if (y2 >= DISPLAY_HEIGHT)
+		y2 = DISPLAY_HEIGHT - 1;
+
+	for (int y = y1; y <= y2; y++)
+	{
+		for (int x = x1; x <= x2; x++)
+		{
+			PutPixel((uint8_t)x, (uint8_t)y, colour);
+		}
+	}
+}
+
+void Platform::DrawFastVLine(int16_t x, int16_t y, uint8_t w, uint8_t pattern)
+{
+	while (w > 0)
+	{
+		uint8_t patternIndex = y % 8;
+		uint8_t mask = 1 << patternIndex;
+		PutPixel((uint8_t)x, (uint8_t)y, (mask & pattern) != 0 ? 1 : 0);
+		y++;
+		w--;
+	}
+}
+
+void Platform::DrawFastHLine(int16_t x, int16_t y, uint8_t w, uint8_t color)
+{
+	while (w > 0)
+	{
+		PutPixel((uint8_t)x, (uint8_t)y, color);
+		x++;
+		w--;
+	}
+}
+
+void Platform::DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color)
+{
+	// bresenham's algorithm - thx wikpedia
+	bool steep = abs(y1 - y0) > abs(x1 - x0);
+	if (steep) {
+		swap(x0, y0);
+		swap(x1, y1);
+	}
+
+	if (x0 > x1) {
+		swap(x0, x1);
+		swap(y0, y1);
+	}
+
+	int16_t dx, dy;
+	dx = x1 - x0;
+	dy = abs(y1 - y0);
+
+	int16_t err = dx / 2;
+	int8_t ystep;
+
+	if (y0 < y1)
+	{
+		ystep = 1;
+	}
+	else
+	{
+		ystep = -1;
+	}
+
+	for (; x0 <= x1; x0++)
+	{
+		if (steep)
+		{
+			PutPixel((uint8_t)y0, (uint8_t)x0, color);
+		}
+		else
+		{
+			PutPixel((uint8_t)x0, (uint8_t)y0, color);
+		}
+
+		err -= dy;
+		if (err < 0)
+		{
+			y0 += ystep;
+			err += dx;
+		}
+	}
+}
+
+void DrawBitmapInternal(const uint8_t* data, int16_t x, int16_t y, uint8_t w, uint8_t h)
+{
+	for (int j = 0; j < h; j++)
+	{
+		for (int i = 0; i < w; i++)
+		{
+			int blockX = i / 8;
+			int blockY = j / 8;
+			int blocksPerWidth = w / 8;
+			int blockIndex = blockY * blocksPerWidth + blockX;
+			uint8_t pixels = data[blockIndex * 8 + i % 8];
+			uint8_t mask = 1 << (j % 8);
+			if (x + i >= 0 && y + j >= 0)
+			{
+				Platform::PutPixel(x + i, y + j, (pixels & mask) ? 1 : 0);
+			}
+		}
+	}
+}
+
+void Platform::DrawBitmap(int16_t x, int16_t y, const uint8_t *bitmap)
+{
+	DrawBitmapInternal(bitmap + 2, x, y, bitmap[0], bitmap[1]);
+}
+
+void Platform::DrawSolidBitmap(int16_t x, int16_t y, const uint8_t *bitmap)
+{
+	DrawBitmapInternal(bitmap + 2, x, y, bitmap[0], bitmap[1]);
+}
+
+void Platform::DrawSprite(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t)
+{
+	uint8_t w = bitmap[0];
+	uint8_t h = bitmap[1];
+
+	bitmap += 2;
+
+	for (int j = 0; j < h; j++)
+	{
+		for (int i = 0; i < w; i++)
+		{
+			int blockY = j / 8;
+			int blockIndex = (w * blockY + i) * 2;
+			uint8_t pixels = bitmap[blockIndex];
+			uint8_t maskPixels = bitmap[blockIndex + 1];
+			uint8_t bitmask = 1 << (j % 8);
+
+			if ((maskPixels & bitmask) && x + i >= 0 && y + j >= 0)
+			{
+				PutPixel(x + i, y + j, (pixels & bitmask) ? 1 : 0);
+			}
+		}
+	}
+}
+
+void Platform::DrawSprite(int16_t x, int16_t y, const uint8_t *bitmap, const uint8_t *mask, uint8_t, uint8_t)
+{
+	uint8_t w = bitmap[0];
+	uint8_t h = bitmap[1];
+
+	bitmap += 2;
+
+	for (int j = 0; j < h; j++)
+	{
+		for (int i = 0; i < w; i++)
+		{
+			int blockY = j / 8;
+			int blockIndex = w * blockY + i;
+			uint8_t pixels = bitmap[blockIndex];
+			uint8_t maskPixels = mask[blockIndex];
+			uint8_t bitmask = 1 << (j % 8);
+
+			if ((maskPixels & bitmask) && x + i >= 0 && y + j >= 0)
+			{
+				PutPixel(x + i, y + j, (pixels & bitmask) ? 1 : 0);
+			}
+		}
+	}
+}
+
+void Platform::DrawBackground()
+{
+	for (int y = 0; y < DISPLAY_HEIGHT; y++)
+	{
+		for (int x = 0; x < DISPLAY_WIDTH; x++)
+		{
+			uint8_t col = y < DISPLAY_HEIGHT / 2 ? (x | y) & 1 ? COLOUR_BLACK : COLOUR_WHITE : (x ^ y) & 1 ? COLOUR_BLACK : COLOUR_WHITE;
+			PutPixel(x, y, col);
+		}
+	}
+}
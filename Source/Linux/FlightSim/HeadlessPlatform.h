@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+
+// Headless host backend: no window, audio or keyboard. The game renders into
+// sBuffer and input is driven by whoever is running the game loop.
+
+extern uint8_t sBuffer[DISPLAY_WIDTH * DISPLAY_HEIGHT / 8];
+
+class HeadlessPlatform
+{
+public:
+	static void SetInput(uint8_t inputMask);
+	static uint8_t GetPixel(uint8_t x, uint8_t y);
+	static void ClearScreen();
+};
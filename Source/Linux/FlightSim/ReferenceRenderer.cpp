@@ -0,0 +1,215 @@
+#include <math.h>
+#include "ReferenceRenderer.h"
+
+extern const uint8_t mapTexture[];
+extern const uint8_t cloudTexture[];
+
+constexpr double groundHeight = 0;
+constexpr double cloudHeight = 128;
+constexpr uint8_t skyColour = 3;
+constexpr int texelSize = 16;
+
+// Same as ditherPattern1 in Game.cpp
+static const uint8_t referenceDitherPattern[] =
+{
+	1, 3,
+	4, 2
+};
+
+// FIXED_ANGLE_TO_RADIANS is single precision
+static double AngleToRadians(double angle)
+{
+	return angle * (2.0 * M_PI / FIXED_ANGLE_MAX);
+}
+
+// Same layout and conventions as Matrix3x3
+struct Matrix3d
+{
+	double m[3][3];
+
+	static Matrix3d RotateX(double angle)
+	{
+		double c = cos(AngleToRadians(angle)), s = sin(AngleToRadians(angle));
+		return Matrix3d { { { 1, 0, 0 }, { 0, c, s }, { 0, -s, c } } };
+	}
+
+	static Matrix3d RotateY(double angle)
+	{
+		double c = cos(AngleToRadians(angle)), s = sin(AngleToRadians(angle));
+		return Matrix3d { { { c, 0, -s }, { 0, 1, 0 }, { s, 0, c } } };
+	}
+
+	static Matrix3d RotateZ(double angle)
+	{
+		double c = cos(AngleToRadians(angle)), s = sin(AngleToRadians(angle));
+		return Matrix3d { { { c, s, 0 }, { -s, c, 0 }, { 0, 0, 1 } } };
+	}
+
+	Matrix3d operator * (const Matrix3d& other) const
+	{
+		Matrix3d result;
+		for (int a = 0; a < 3; a++)
+		{
+			for (int b = 0; b < 3; b++)
+			{
+				result.m[b][a] = m[b][0] * other.m[0][a] + m[b][1] * other.m[1][a] + m[b][2] * other.m[2][a];
+			}
+		}
+		return result;
+	}
+
+	void Transform(double x, double y, double z, double& outX, double& outY, double& outZ) const
+	{
+		outX = x * m[0][0] + y * m[1][0] + z * m[2][0];
+		outY = x * m[0][1] + y * m[1][1] + z * m[2][1];
+		outZ = x * m[0][2] + y * m[1][2] + z * m[2][2];
+	}
+};
+
+static int WrapTexel(double worldCoord, int textureSize)
+{
+	double texel = fmod(floor(worldCoord / texelSize), textureSize);
+	return texel < 0 ? (int)texel + textureSize : (int)texel;
+}
+
+static uint8_t CastRay(const ReferenceView& view, double dirX, double dirY, double dirZ)
+{
+	if (dirY == 0)
+	{
+		return skyColour;
+	}
+
+	// Nearest plane in front of the camera
+	double groundT = (groundHeight - view.y) / dirY;
+	double cloudT = (cloudHeight - view.y) / dirY;
+	bool hitsGround = groundT > 0 && (cloudT <= 0 || groundT < cloudT);
+	bool hitsCloud = cloudT > 0 && !hitsGround;
+
+	if (hitsGround)
+	{
+		int u = WrapTexel(view.x + dirX * groundT, 64);
+		int v = WrapTexel(view.z + dirZ * groundT, 64);
+		return pgm_read_byte(&mapTexture[v * 64 + u]);
+	}
+	if (hitsCloud)
+	{
+		int u = WrapTexel(view.x + dirX * cloudT, 32);
+		int v = WrapTexel(view.z + dirZ * cloudT, 32);
+		return pgm_read_byte(&cloudTexture[v * 32 + u]);
+	}
+
+	return skyColour;
+}
+
+void ReferenceRenderer::Render(const ReferenceView& view, uint8_t* outIntensity)
+{
+	Matrix3d rotation = Matrix3d::RotateZ(view.roll) * Matrix3d::RotateX(-view.pitch) * Matrix3d::RotateY(-view.yaw);
+	Matrix3d viewRotation = Matrix3d::RotateX(view.tilt) * rotation;
+
+	for (int blockY = 0; blockY < blocksHigh; blockY++)
+	{
+		double viewY = 0.5 - (blockY * 2 + view.rowOffset) / 64.0;
+
+		for (int blockX = 0; blockX < blocksWide; blockX++)
+		{
+			double viewX = -1.0 + blockX / 32.0;
+			double dirX, dirY, dirZ;
+			viewRotation.Transform(viewX, viewY, 1.0, dirX, dirY, dirZ);
+
+			outIntensity[blockY * blocksWide + blockX] = CastRay(view, dirX, dirY, dirZ);
+		}
+	}
+}
+
+void ReferenceRenderer::Dither(const uint8_t* intensity, uint8_t* outScreenBuffer)
+{
+	for (int y = 0; y < DISPLAY_HEIGHT; y++)
+	{
+		for (int x = 0; x < DISPLAY_WIDTH; x++)
+		{
+			uint8_t colour = intensity[(y / 2) * blocksWide + x / 2];
+			uint8_t* screenPtr = &outScreenBuffer[(y / 8) * DISPLAY_WIDTH + x];
+			uint8_t mask = 1 << (y & 7);
+
+			if (colour >= referenceDitherPattern[(y & 1) * 2 + (x & 1)])
+				*screenPtr |= mask;
+			else
+				*screenPtr &= ~mask;
+		}
+	}
+}
+
+void ReferenceRenderer::ExtractIntensity(const uint8_t* screenBuffer, uint8_t* outIntensity)
+{
+	for (int blockY = 0; blockY < blocksHigh; blockY++)
+	{
+		for (int blockX = 0; blockX < blocksWide; blockX++)
+		{
+			uint8_t count = 0;
+
+			for (int n = 0; n < 4; n++)
+			{
+				int x = blockX * 2 + (n & 1);
+				int y = blockY * 2 + (n >> 1);
+				if (screenBuffer[(y / 8) * DISPLAY_WIDTH + x] & (1 << (y & 7)))
+					count++;
+			}
+
+			outIntensity[blockY * blocksWide + blockX] = count;
+		}
+	}
+}
+
+bool ReferenceRenderer::IsInViewport(int blockX, int blockY)
+{
+	// Same limits as the renderers, the left and right thirds are obscured by the MFDs
+	int x = blockX * 2;
+	int displayHeight = x < 40 || x >= DISPLAY_WIDTH - 40 ? DISPLAY_HEIGHT - 24 : DISPLAY_HEIGHT - 16;
+	return blockY * 2 < displayHeight;
+}
+
+FrameError ReferenceRenderer::Compare(const uint8_t* reference, const uint8_t* intensity)
+{
+	FrameError error = {};
+
+	for (int blockY = 0; blockY < blocksHigh; blockY++)
+	{
+		for (int blockX = 0; blockX < blocksWide; blockX++)
+		{
+			if (!IsInViewport(blockX, blockY))
+				continue;
+
+			int index = blockY * blocksWide + blockX;
+			int difference = (int)intensity[index] - (int)reference[index];
+
+			error.numBlocks++;
+			if (difference != 0)
+				error.mismatches++;
+			error.squaredError += difference * difference;
+		}
+	}
+
+	return error;
+}
+
+double FrameError::MismatchRate() const
+{
+	return numBlocks ? (double)mismatches / numBlocks : 0.0;
+}
+
+double FrameError::PSNR() const
+{
+	if (squaredError == 0)
+		return INFINITY;
+
+	double meanSquaredError = squaredError / numBlocks;
+	return 10.0 * log10((ReferenceRenderer::maxIntensity * ReferenceRenderer::maxIntensity) / meanSquaredError);
+}
+
+FrameError& FrameError::operator += (const FrameError& other)
+{
+	numBlocks += other.numBlocks;
+	mismatches += other.mismatches;
+	squaredError += other.squaredError;
+	return *this;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+#include "FixedMath.h"
+
+// Double precision ray caster for the ground and cloud planes, used as ground truth for
+// measuring the quality of the fixed point renderers.
+// Everything is compared as the pre-dither intensity (0-4) of each 2x2 pixel block, which for
+// ditherPattern1 is just the number of lit pixels in the block.
+
+struct ReferenceView
+{
+	double pitch, roll, yaw;		// In angle_t units, but not limited to whole steps
+	double x, y, z;					// Camera position in world units
+	double tilt;					// Extra RotateX applied before the camera rotation
+	double rowOffset;				// Screen row y looks along 0.5 - (y + rowOffset) / 64
+};
+
+struct FrameError
+{
+	int numBlocks;
+	int mismatches;
+	double squaredError;
+
+	double MismatchRate() const;
+	double PSNR() const;
+
+	FrameError& operator += (const FrameError& other);
+};
+
+class ReferenceRenderer
+{
+public:
+	static constexpr int blocksWide = DISPLAY_WIDTH / 2;
+	static constexpr int blocksHigh = DISPLAY_HEIGHT / 2;
+	static constexpr int numBlocks = blocksWide * blocksHigh;
+	static constexpr int maxIntensity = 4;
+
+	// Pre-dither intensity for each block, sampled at the block's top left pixel like the game renderers
+	static void Render(const ReferenceView& view, uint8_t* outIntensity);
+
+	// Writes intensities to a screen buffer with the same 2x2 pattern as DitherWriter
+	static void Dither(const uint8_t* intensity, uint8_t* outScreenBuffer);
+
+	// Recovers block intensities from a dithered screen buffer
+	static void ExtractIntensity(const uint8_t* screenBuffer, uint8_t* outIntensity);
+
+	// Only counts blocks inside the viewport that isn't covered by the HUD
+	static FrameError Compare(const uint8_t* reference, const uint8_t* intensity);
+	static bool IsInViewport(int blockX, int blockY);
+};
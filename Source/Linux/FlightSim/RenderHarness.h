@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include "Defines.h"
+#include "Game.h"
+#include "FixedMath.h"
+
+// Shared helpers for host tools that drive the renderers directly
+
+struct DrawMethod
+{
+	const char* name;
+	void (*draw)();
+
+	// View setup used by the renderer: the view is rotated by RotateX(tilt) and
+	// screen row y looks along 0.5 - (y + rowOffset) / 64
+	angle_t tilt;
+	int8_t rowOffset;
+};
+
+static const DrawMethod DrawMethods[] =
+{
+	{ "QuarterRes", GameDrawQuarterRes, 0, 8 },
+	{ "HalfRes", GameDrawHalfRes, 0, 8 },
+	{ "FullRes", GameDrawFullRes, 0, 8 },
+	{ "Interp", GameDrawInterp, 4, 0 },
+	{ "Lines", GameDrawLines, 4, 0 },
+	{ "Grid", GameDrawGrid, 4, 0 },
+	{ "Simple", GameDrawSimple, 0, 0 },
+};
+
+struct CameraPose
+{
+	angle_t pitch, roll, yaw;
+	int16_t altitude;
+};
+
+// Fixed grid of pitch / roll / yaw / altitude combinations
+inline std::vector<CameraPose> BuildPoseSweep()
+{
+	constexpr int16_t altitudes[] = { 1, 20, 75, 120 };
+	std::vector<CameraPose> poses;
+
+	for (int16_t altitude : altitudes)
+	{
+		for (int yaw = 0; yaw < FIXED_ANGLE_MAX; yaw += FIXED_ANGLE_MAX / 4)
+		{
+			for (int roll = 0; roll < FIXED_ANGLE_MAX; roll += FIXED_ANGLE_MAX / 8)
+			{
+				for (int pitch = 0; pitch < FIXED_ANGLE_MAX; pitch += FIXED_ANGLE_MAX / 16)
+				{
+					CameraPose pose;
+					pose.pitch = (angle_t)pitch;
+					pose.roll = (angle_t)roll;
+					pose.yaw = (angle_t)yaw;
+					pose.altitude = altitude;
+					poses.push_back(pose);
+				}
+			}
+		}
+	}
+
+	return poses;
+}
+
+inline void ApplyPose(const CameraPose& pose)
+{
+	camera.position = Vector3s(64 * 16, pose.altitude, 64 * 16);
+	camera.pitch = pose.pitch;
+	camera.roll = pose.roll;
+	camera.yaw = pose.yaw;
+	camera.UpdateRotation();
+}
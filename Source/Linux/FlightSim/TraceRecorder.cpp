@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "TraceRecorder.h"
+#include "Game.h"
+#include "OpCounters.h"
+
+#if PROFILER
+
+// Fixed capacity buffer that overwrites the oldest entry once full
+template <typename T>
+class RingBuffer
+{
+public:
+	void Allocate(uint32_t capacity)
+	{
+		entries.assign(capacity, T());
+		head = 0;
+		size = 0;
+		dropped = 0;
+	}
+
+	T& Push()
+	{
+		T& entry = entries[head];
+		head = (head + 1) % entries.size();
+		if (size < entries.size())
+			size++;
+		else
+			dropped++;
+		return entry;
+	}
+
+	// Index 0 is the oldest entry
+	const T& operator[](uint32_t index) const
+	{
+		return entries[(head + entries.size() - size + index) % entries.size()];
+	}
+
+	std::vector<T> entries;
+	uint32_t head = 0;
+	uint32_t size = 0;
+	uint32_t dropped = 0;
+};
+
+struct TraceEvent
+{
+	uint64_t startTime;
+	uint32_t duration;
+	uint32_t frame;
+	uint8_t zone;		// ProfileZone, or NumZones for the whole frame
+};
+
+struct FrameRecord
+{
+	uint32_t frame;
+	uint32_t duration;
+	Vector3s position;
+	angle_t pitch, roll, yaw;
+	uint32_t zoneTimes[(int)ProfileZone::NumZones];
+	uint32_t divides;
+	uint32_t fetches;
+};
+
+constexpr uint8_t frameZone = (uint8_t)ProfileZone::NumZones;
+
+static RingBuffer<TraceEvent> events;
+static RingBuffer<FrameRecord> frames;
+static uint32_t frameIndex;
+static uint64_t frameStartTime;
+static uint64_t traceStartTime;
+
+#if OP_COUNTERS
+static uint32_t lastDivides, lastFetches;
+#endif
+
+static uint64_t GetTime64()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Profiler times are the bottom 32 bits of the same clock, so can be widened using a nearby full time
+static uint64_t WidenTime(uint32_t time)
+{
+	return frameStartTime + (int64_t)(int32_t)(time - (uint32_t)frameStartTime);
+}
+
+static void OnZoneEnd(ProfileZone zone, uint32_t startTime, uint32_t endTime)
+{
+	TraceEvent& event = events.Push();
+	event.startTime = WidenTime(startTime);
+	event.duration = endTime - startTime;
+	event.frame = frameIndex;
+	event.zone = (uint8_t)zone;
+}
+
+void TraceRecorder::Start(uint32_t maxEvents, uint32_t maxFrames)
+{
+	events.Allocate(maxEvents);
+	frames.Allocate(maxFrames);
+	frameIndex = 0;
+	traceStartTime = frameStartTime = GetTime64();
+	Profiler::zoneListener = OnZoneEnd;
+}
+
+void TraceRecorder::Stop()
+{
+	Profiler::zoneListener = nullptr;
+}
+
+void TraceRecorder::BeginFrame()
+{
+	frameStartTime = GetTime64();
+}
+
+void TraceRecorder::EndFrame()
+{
+	uint64_t frameEndTime = GetTime64();
+
+	TraceEvent& event = events.Push();
+	event.startTime = frameStartTime;
+	event.duration = (uint32_t)(frameEndTime - frameStartTime);
+	event.frame = frameIndex;
+	event.zone = frameZone;
+
+	FrameRecord& record = frames.Push();
+	record.frame = frameIndex;
+	record.duration = event.duration;
+	record.position = camera.position;
+	record.pitch = camera.pitch;
+	record.roll = camera.roll;
+	record.yaw = camera.yaw;
+	for (int n = 0; n < (int)ProfileZone::NumZones; n++)
+	{
+		record.zoneTimes[n] = Profiler::zoneTimes[n];
+	}
+
+#if OP_COUNTERS
+	uint32_t divides = OpCounters::counts[(int)OpCounter::QuickDivide];
+	uint32_t fetches = OpCounters::counts[(int)OpCounter::ProgmemReadByte] + OpCounters::counts[(int)OpCounter::ProgmemReadWord];
+	record.divides = divides - lastDivides;
+	record.fetches = fetches - lastFetches;
+	lastDivides = divides;
+	lastFetches = fetches;
+#else
+	record.divides = record.fetches = 0;
+#endif
+
+	frameIndex++;
+}
+
+uint32_t TraceRecorder::GetDroppedEvents()
+{
+	return events.dropped;
+}
+
+uint32_t TraceRecorder::GetDroppedFrames()
+{
+	return frames.dropped;
+}
+
+bool TraceRecorder::WriteChromeTrace(const char* filename)
+{
+	FILE* fs = fopen(filename, "w");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", filename);
+		return false;
+	}
+
+	// Complete ("X") events with timestamps in microseconds
+	fprintf(fs, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	fprintf(fs, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"Game\"}}");
+
+	for (uint32_t n = 0; n < events.size; n++)
+	{
+		const TraceEvent& event = events[n];
+		double timestamp = (int64_t)(event.startTime - traceStartTime) / 1000.0;
+		double duration = event.duration / 1000.0;
+
+		if (event.zone == frameZone)
+		{
+			fprintf(fs, ",\n{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":0,\"args\":{\"frame\":%u}}",
+				timestamp, duration, event.frame);
+		}
+		else
+		{
+			fprintf(fs, ",\n{\"name\":\"%s\",\"cat\":\"zone\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":0}",
+				Profiler::GetZoneName((ProfileZone)event.zone), timestamp, duration);
+		}
+	}
+
+	fprintf(fs, "\n]}\n");
+	fclose(fs);
+	return true;
+}
+
+bool TraceRecorder::WriteFrameCsv(const char* filename)
+{
+	FILE* fs = fopen(filename, "w");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", filename);
+		return false;
+	}
+
+	fprintf(fs, "frame,x,y,z,pitch,roll,yaw,frame_%s", Profiler::timeUnit);
+	for (int n = 0; n < (int)ProfileZone::NumZones; n++)
+	{
+		fprintf(fs, ",%s_%s", Profiler::GetZoneName((ProfileZone)n), Profiler::timeUnit);
+	}
+#if OP_COUNTERS
+	fprintf(fs, ",divides,fetches");
+#endif
+	fprintf(fs, "\n");
+
+	for (uint32_t n = 0; n < frames.size; n++)
+	{
+		const FrameRecord& record = frames[n];
+		const float scale = 1.0f / (1 << FixedFractionalBits);
+		fprintf(fs, "%u,%.3f,%.3f,%.3f,%u,%u,%u,%u", record.frame,
+			record.position.x.rawValue * scale, record.position.y.rawValue * scale, record.position.z.rawValue * scale,
+			record.pitch, record.roll, record.yaw, record.duration);
+		for (int z = 0; z < (int)ProfileZone::NumZones; z++)
+		{
+			fprintf(fs, ",%u", record.zoneTimes[z]);
+		}
+#if OP_COUNTERS
+		fprintf(fs, ",%u,%u", record.divides, record.fetches);
+#endif
+		fprintf(fs, "\n");
+	}
+
+	fclose(fs);
+	return true;
+}
+
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+#include "Profiler.h"
+
+// Records profiling zones and per frame metrics from host runs into fixed size ring buffers,
+// so that nothing is allocated or written to disk while the game is running. Once the run is
+// over the most recent events can be written out as a Chrome trace (chrome://tracing, Perfetto)
+// and the most recent frames as a CSV.
+// Requires PROFILER=1. Divide and fetch counts are only recorded when built with OP_COUNTERS=1.
+
+#if PROFILER
+class TraceRecorder
+{
+public:
+	static constexpr uint32_t defaultMaxEvents = 1 << 20;
+	static constexpr uint32_t defaultMaxFrames = 1 << 16;
+
+	// Allocates the ring buffers and starts listening to profiling zones
+	static void Start(uint32_t maxEvents = defaultMaxEvents, uint32_t maxFrames = defaultMaxFrames);
+	static void Stop();
+
+	static void BeginFrame();
+	static void EndFrame();
+
+	static bool WriteChromeTrace(const char* filename);
+	static bool WriteFrameCsv(const char* filename);
+
+	static uint32_t GetDroppedEvents();
+	static uint32_t GetDroppedFrames();
+};
+#endif
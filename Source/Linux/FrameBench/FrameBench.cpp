@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "HeadlessPlatform.h"
+#include "RenderHarness.h"
+
+// Times each renderer over a fixed sweep of camera poses.
+// Usage: FrameBench [-reps N] [-method NAME]
+
+struct PoseTiming
+{
+	double nsPerFrame;
+	int poseIndex;
+
+	bool operator < (const PoseTiming& other) const
+	{
+		return nsPerFrame < other.nsPerFrame;
+	}
+};
+
+void BenchmarkMethod(const DrawMethod& method, const std::vector<CameraPose>& poses, int reps)
+{
+	std::vector<PoseTiming> timings;
+	double totalNs = 0;
+
+	for (unsigned n = 0; n < poses.size(); n++)
+	{
+		// Take the fastest repetition so that scheduler noise doesn't show up as a slow pose.
+		// GameDrawSimple mutates the camera so the pose is reapplied every frame.
+		double poseNs = 0;
+
+		for (int rep = 0; rep < reps; rep++)
+		{
+			ApplyPose(poses[n]);
+
+			auto startTime = std::chrono::steady_clock::now();
+			method.draw();
+			auto endTime = std::chrono::steady_clock::now();
+
+			double frameNs = std::chrono::duration<double, std::nano>(endTime - startTime).count();
+			if (rep == 0 || frameNs < poseNs)
+			{
+				poseNs = frameNs;
+			}
+		}
+
+		PoseTiming timing;
+		timing.nsPerFrame = poseNs;
+		timing.poseIndex = n;
+		timings.push_back(timing);
+		totalNs += timing.nsPerFrame;
+	}
+
+	std::sort(timings.begin(), timings.end());
+
+	const PoseTiming& worst = timings.back();
+	const CameraPose& worstPose = poses[worst.poseIndex];
+
+	printf("%-12s %10.0f %10.0f %10.0f %10.0f   pitch=%3d roll=%3d yaw=%3d alt=%3d\n",
+		method.name,
+		totalNs / timings.size(),
+		timings.front().nsPerFrame,
+		timings[timings.size() / 2].nsPerFrame,
+		worst.nsPerFrame,
+		worstPose.pitch, worstPose.roll, worstPose.yaw, worstPose.altitude);
+}
+
+int main(int argc, char* argv[])
+{
+	int reps = 16;
+	const char* methodFilter = nullptr;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-reps") && n + 1 < argc)
+		{
+			reps = atoi(argv[++n]);
+		}
+		else if (!strcmp(argv[n], "-method") && n + 1 < argc)
+		{
+			methodFilter = argv[++n];
+		}
+		else
+		{
+			printf("Usage: %s [-reps N] [-method NAME]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (reps < 1)
+	{
+		reps = 1;
+	}
+
+	SeedRandom(0);
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+
+	std::vector<CameraPose> poses = BuildPoseSweep();
+
+	printf("%d poses, best of %d reps per pose, times in ns/frame\n\n", (int)poses.size(), reps);
+	printf("%-12s %10s %10s %10s %10s   %s\n", "Method", "Mean", "Min", "Median", "Max", "Worst pose");
+
+	for (const DrawMethod& method : DrawMethods)
+	{
+		if (methodFilter && strcmp(methodFilter, method.name))
+		{
+			continue;
+		}
+
+		BenchmarkMethod(method, poses, reps);
+	}
+
+	return 0;
+}
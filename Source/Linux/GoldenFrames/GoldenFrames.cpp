@@ -0,0 +1,332 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "Defines.h"
+#include "Game.h"
+#include "Dither.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "HeadlessPlatform.h"
+#include "StateHash.h"
+#include "RenderHarness.h"
+#include "lodepng.h"
+
+// Renders a fixed corpus of poses through every draw method and checks the hash of sBuffer
+// against the checked in golden hashes, so that renderer optimisations can be shown to be
+// bit identical. Exits with 1 if any frame differs.
+// To see where a frame differs, record the frames of a known good build with -record DIR and
+// pass the same directory to -expected: each mismatch then writes a PNG with the expected
+// frame, the actual frame and their XOR.
+// Before the corpus, WriteDitherBlock is checked against DitherWriter for every colour of every
+// block in a page, as a difference there only shows in the frames of the methods that use it.
+// Usage: GoldenFrames [-golden FILE] [-update] [-record DIR] [-expected DIR] [-o DIR]
+
+#ifndef GOLDEN_HASHES_FILE
+#define GOLDEN_HASHES_FILE "GoldenHashes.txt"
+#endif
+
+constexpr int screenBufferSize = DISPLAY_WIDTH * DISPLAY_HEIGHT / 8;
+// Coprime with the 16 pitch steps of the sweep so that every pitch is covered
+constexpr int corpusStride = 5;
+
+struct GoldenFrame
+{
+	const DrawMethod* method;
+	CameraPose pose;
+	uint32_t hash;
+};
+
+static std::string GetFrameName(const char* methodName, const CameraPose& pose)
+{
+	char poseName[64];
+	snprintf(poseName, sizeof(poseName), "_%d_%d_%d_%d", pose.pitch, pose.roll, pose.yaw, pose.altitude);
+	return methodName + std::string(poseName);
+}
+
+// Every combination of colours 0 to 4 down the four blocks of a page, written by DitherWriter with
+// ditherPattern1 and by WriteDitherBlock over a filled page, must give the same bytes
+static bool CheckDitherBlocks()
+{
+	constexpr int numColours = 5;
+	uint8_t* screen = Platform::GetScreenBuffer();
+	int numMismatches = 0;
+
+	for (int combination = 0; combination < numColours * numColours * numColours * numColours; combination++)
+	{
+		uint8_t colours[4];
+		for (int block = 0, remaining = combination; block < 4; block++, remaining /= numColours)
+			colours[block] = (uint8_t)(remaining % numColours);
+
+		DitherWriter ditherWriter(screen, ditherPattern1, 4);
+		for (uint8_t colour : colours)
+			ditherWriter.Write(colour);
+		const uint8_t expected[2] = { screen[0], screen[1] };
+
+		screen[0] = screen[1] = 0xff;
+		for (uint8_t block = 0; block < 4; block++)
+			WriteDitherBlock(0, block, colours[block]);
+
+		if (screen[0] != expected[0] || screen[1] != expected[1])
+		{
+			printf("WriteDitherBlock colours %d %d %d %d: expected %02x %02x, got %02x %02x\n",
+				colours[0], colours[1], colours[2], colours[3], expected[0], expected[1], screen[0], screen[1]);
+			numMismatches++;
+		}
+	}
+
+	HeadlessPlatform::ClearScreen();
+	return numMismatches == 0;
+}
+
+static uint32_t RenderFrame(const DrawMethod& method, const CameraPose& pose)
+{
+	ApplyPose(pose);
+	HeadlessPlatform::ClearScreen();
+	method.draw();
+	return StateHash::HashScreen();
+}
+
+static bool ReadGoldenHashes(const char* filename, std::map<std::string, uint32_t>& outHashes)
+{
+	FILE* fs = fopen(filename, "r");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", filename);
+		return false;
+	}
+
+	char line[256];
+	while (fgets(line, sizeof(line), fs))
+	{
+		char methodName[64];
+		int pitch, roll, yaw, altitude;
+		unsigned hash;
+
+		if (line[0] == '#' || sscanf(line, "%63s %d %d %d %d %x", methodName, &pitch, &roll, &yaw, &altitude, &hash) != 6)
+			continue;
+
+		CameraPose pose = { (angle_t)pitch, (angle_t)roll, (angle_t)yaw, (int16_t)altitude };
+		outHashes[GetFrameName(methodName, pose)] = hash;
+	}
+
+	fclose(fs);
+	return true;
+}
+
+static bool WriteGoldenHashes(const char* filename, const std::vector<GoldenFrame>& frames)
+{
+	FILE* fs = fopen(filename, "w");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", filename);
+		return false;
+	}
+
+	fprintf(fs, "# Golden sBuffer hashes (FNV-1a) checked by GoldenFrames, regenerate with GoldenFrames -update\n");
+	fprintf(fs, "# method pitch roll yaw altitude hash\n");
+	for (const GoldenFrame& frame : frames)
+	{
+		fprintf(fs, "%s %d %d %d %d %08x\n", frame.method->name, frame.pose.pitch, frame.pose.roll, frame.pose.yaw, frame.pose.altitude, frame.hash);
+	}
+
+	fclose(fs);
+	return true;
+}
+
+static bool WriteScreenBuffer(const std::string& path)
+{
+	FILE* fs = fopen(path.c_str(), "wb");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", path.c_str());
+		return false;
+	}
+	fwrite(Platform::GetScreenBuffer(), 1, screenBufferSize, fs);
+	fclose(fs);
+	return true;
+}
+
+static bool ReadScreenBuffer(const std::string& path, uint8_t* outBuffer)
+{
+	FILE* fs = fopen(path.c_str(), "rb");
+	if (!fs)
+	{
+		return false;
+	}
+	bool success = fread(outBuffer, 1, screenBufferSize, fs) == screenBufferSize;
+	fclose(fs);
+	return success;
+}
+
+static bool GetBufferPixel(const uint8_t* buffer, int x, int y)
+{
+	return (buffer[(y / 8) * DISPLAY_WIDTH + x] & (1 << (y & 7))) != 0;
+}
+
+// Expected, actual and XOR frames stacked vertically
+static void WriteDifference(const std::string& path, const uint8_t* expected, const uint8_t* actual)
+{
+	constexpr int imageHeight = DISPLAY_HEIGHT * 3 + 2;
+	std::vector<uint8_t> image(DISPLAY_WIDTH * imageHeight, 128);
+	int numDiffering = 0;
+	int minX = DISPLAY_WIDTH, minY = DISPLAY_HEIGHT, maxX = -1, maxY = -1;
+
+	for (int y = 0; y < DISPLAY_HEIGHT; y++)
+	{
+		for (int x = 0; x < DISPLAY_WIDTH; x++)
+		{
+			bool expectedPixel = GetBufferPixel(expected, x, y);
+			bool actualPixel = GetBufferPixel(actual, x, y);
+
+			image[y * DISPLAY_WIDTH + x] = expectedPixel ? 255 : 0;
+			image[(y + DISPLAY_HEIGHT + 1) * DISPLAY_WIDTH + x] = actualPixel ? 255 : 0;
+			image[(y + (DISPLAY_HEIGHT + 1) * 2) * DISPLAY_WIDTH + x] = expectedPixel != actualPixel ? 255 : 0;
+
+			if (expectedPixel != actualPixel)
+			{
+				numDiffering++;
+				if (x < minX) minX = x;
+				if (x > maxX) maxX = x;
+				if (y < minY) minY = y;
+				if (y > maxY) maxY = y;
+			}
+		}
+	}
+
+	if (numDiffering)
+		printf("  %d pixels differ in x=%d..%d y=%d..%d\n", numDiffering, minX, maxX, minY, maxY);
+	else
+		printf("  Matches the expected frame, so the expected frames and golden hashes are out of sync\n");
+
+	unsigned error = lodepng::encode(path, image, DISPLAY_WIDTH, imageHeight, LCT_GREY);
+	if (error)
+	{
+		printf("%s : encoder error %u: %s\n", path.c_str(), error, lodepng_error_text(error));
+	}
+	else
+	{
+		printf("  Wrote %s\n", path.c_str());
+	}
+}
+
+static void WriteFrame(const std::string& path, const uint8_t* buffer)
+{
+	std::vector<uint8_t> image(DISPLAY_WIDTH * DISPLAY_HEIGHT);
+	for (int y = 0; y < DISPLAY_HEIGHT; y++)
+	{
+		for (int x = 0; x < DISPLAY_WIDTH; x++)
+		{
+			image[y * DISPLAY_WIDTH + x] = GetBufferPixel(buffer, x, y) ? 255 : 0;
+		}
+	}
+
+	unsigned error = lodepng::encode(path, image, DISPLAY_WIDTH, DISPLAY_HEIGHT, LCT_GREY);
+	if (error)
+	{
+		printf("%s : encoder error %u: %s\n", path.c_str(), error, lodepng_error_text(error));
+	}
+	else
+	{
+		printf("  Wrote %s (no expected frame, use -expected for a difference)\n", path.c_str());
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const char* goldenFilename = GOLDEN_HASHES_FILE;
+	const char* recordDir = nullptr;
+	const char* expectedDir = nullptr;
+	std::string outputDir = ".";
+	bool update = false;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-golden") && n + 1 < argc)
+			goldenFilename = argv[++n];
+		else if (!strcmp(argv[n], "-update"))
+			update = true;
+		else if (!strcmp(argv[n], "-record") && n + 1 < argc)
+			recordDir = argv[++n];
+		else if (!strcmp(argv[n], "-expected") && n + 1 < argc)
+			expectedDir = argv[++n];
+		else if (!strcmp(argv[n], "-o") && n + 1 < argc)
+			outputDir = argv[++n];
+		else
+		{
+			printf("Usage: %s [-golden FILE] [-update] [-record DIR] [-expected DIR] [-o DIR]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	std::map<std::string, uint32_t> goldenHashes;
+	if (!update && !ReadGoldenHashes(goldenFilename, goldenHashes))
+	{
+		return 1;
+	}
+
+	std::vector<CameraPose> allPoses = BuildPoseSweep();
+	std::vector<GoldenFrame> frames;
+	int numMismatches = 0, numMissing = 0;
+
+	if (!CheckDitherBlocks())
+	{
+		return 1;
+	}
+
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+
+	for (const DrawMethod& method : DrawMethods)
+	{
+		for (size_t p = 0; p < allPoses.size(); p += corpusStride)
+		{
+			const CameraPose& pose = allPoses[p];
+			GoldenFrame frame = { &method, pose, RenderFrame(method, pose) };
+			frames.push_back(frame);
+
+			std::string name = GetFrameName(method.name, pose);
+
+			if (recordDir && !WriteScreenBuffer(std::string(recordDir) + "/" + name + ".bin"))
+			{
+				return 1;
+			}
+
+			if (update)
+				continue;
+
+			auto golden = goldenHashes.find(name);
+			if (golden == goldenHashes.end())
+			{
+				printf("%s: no golden hash\n", name.c_str());
+				numMissing++;
+				continue;
+			}
+			if (golden->second == frame.hash)
+				continue;
+
+			printf("%s: expected %08x, got %08x\n", name.c_str(), golden->second, frame.hash);
+			numMismatches++;
+
+			uint8_t expected[screenBufferSize];
+			std::string imagePath = outputDir + "/" + name + ".png";
+			if (expectedDir && ReadScreenBuffer(std::string(expectedDir) + "/" + name + ".bin", expected))
+				WriteDifference(imagePath, expected, Platform::GetScreenBuffer());
+			else
+				WriteFrame(imagePath, Platform::GetScreenBuffer());
+		}
+	}
+
+	if (update)
+	{
+		if (!WriteGoldenHashes(goldenFilename, frames))
+			return 1;
+		printf("Wrote %d golden hashes to %s\n", (int)frames.size(), goldenFilename);
+		return 0;
+	}
+
+	printf("%d frames, %d mismatched, %d without a golden hash\n", (int)frames.size(), numMismatches, numMissing);
+	return numMismatches || numMissing ? 1 : 0;
+}
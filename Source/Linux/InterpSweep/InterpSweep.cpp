@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "OpCounters.h"
+#include "HeadlessPlatform.h"
+#include "RenderHarness.h"
+#include "ReferenceRenderer.h"
+
+// Sweeps the GameDrawInterp constants over a grid, measuring estimated cycles and error against
+// the reference renderer over the pose sweep, then prints the configurations on the Pareto frontier
+// of mean cycles against mean squared error.
+// Must be linked against a game library built with INTERP_TUNING=1 and OP_COUNTERS=1.
+// Usage: InterpSweep [-stride N] [-csv FILE]
+
+#if !INTERP_TUNING || !OP_COUNTERS
+#error InterpSweep requires INTERP_TUNING=1 and OP_COUNTERS=1
+#endif
+
+static const int8_t maxTexelErrors[] = { 8, 16, 32 };
+static const uint8_t maxSpanSplits[] = { 0, 1, 2, 4 };
+static const int8_t groundThresholds[] = { -1, -2, -3, -4, -6 };
+static const int8_t cloudThresholds[] = { 4, 6, 8, 12, 16 };
+static const uint8_t blockShifts[] = { 1, 2, 3 };
+static const angle_t cameraTilts[] = { 0, 2, 4, 6 };
+
+constexpr int numTilts = sizeof(cameraTilts) / sizeof(cameraTilts[0]);
+
+struct SweepResult
+{
+	InterpSettings settings;
+	double meanCycles;
+	uint32_t maxCycles;
+	FrameError error;
+	bool pareto;
+};
+
+static bool IsDefault(const InterpSettings& settings)
+{
+	return settings.maxTexelError == defaultInterpSettings.maxTexelError
+		&& settings.maxSpanSplits == defaultInterpSettings.maxSpanSplits
+		&& settings.groundThreshold == defaultInterpSettings.groundThreshold
+		&& settings.cloudThreshold == defaultInterpSettings.cloudThreshold
+		&& settings.blockShift == defaultInterpSettings.blockShift
+		&& settings.cameraTilt == defaultInterpSettings.cameraTilt;
+}
+
+static double MeanSquaredError(const FrameError& error)
+{
+	return error.numBlocks ? error.squaredError / error.numBlocks : 0.0;
+}
+
+static void PrintResultHeader()
+{
+	printf("%7s %7s %7s %7s %6s %5s %10s %10s %9s %8s\n", "texels", "splits", "ground", "cloud", "block", "tilt", "mean cyc", "max cyc", "mismatch", "PSNR");
+}
+
+static void PrintResult(const SweepResult& result)
+{
+	printf("%7.2f %7d %7d %7d %6d %5d %10.0f %10u %8.2f%% %8.2f%s\n",
+		result.settings.maxTexelError.rawValue / 64.0, result.settings.maxSpanSplits, result.settings.groundThreshold.rawValue, result.settings.cloudThreshold.rawValue,
+		1 << result.settings.blockShift, result.settings.cameraTilt, result.meanCycles, result.maxCycles,
+		result.error.MismatchRate() * 100.0, result.error.PSNR(), IsDefault(result.settings) ? "  (default)" : "");
+}
+
+int main(int argc, char* argv[])
+{
+	int stride = 8;
+	const char* csvFilename = nullptr;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-stride") && n + 1 < argc)
+		{
+			stride = atoi(argv[++n]);
+		}
+		else if (!strcmp(argv[n], "-csv") && n + 1 < argc)
+		{
+			csvFilename = argv[++n];
+		}
+		else
+		{
+			printf("Usage: %s [-stride N] [-csv FILE]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (stride <= 0)
+	{
+		printf("Stride must be positive\n");
+		return 1;
+	}
+
+	// Every stride'th pose of the sweep
+	std::vector<CameraPose> allPoses = BuildPoseSweep();
+	std::vector<CameraPose> poses;
+	for (size_t n = 0; n < allPoses.size(); n += stride)
+	{
+		poses.push_back(allPoses[n]);
+	}
+
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+
+	// The reference only depends on the tilt, so render it once per tilt and pose
+	std::vector<uint8_t> references(numTilts * poses.size() * ReferenceRenderer::numBlocks);
+	for (int t = 0; t < numTilts; t++)
+	{
+		for (size_t p = 0; p < poses.size(); p++)
+		{
+			ApplyPose(poses[p]);
+
+			ReferenceView view;
+			view.pitch = poses[p].pitch;
+			view.roll = poses[p].roll;
+			view.yaw = poses[p].yaw;
+			view.x = camera.position.x.rawValue / 64.0;
+			view.y = camera.position.y.rawValue / 64.0;
+			view.z = camera.position.z.rawValue / 64.0;
+			view.tilt = cameraTilts[t];
+			view.rowOffset = 0;
+			ReferenceRenderer::Render(view, &references[(t * poses.size() + p) * ReferenceRenderer::numBlocks]);
+		}
+	}
+
+	std::vector<SweepResult> results;
+	uint8_t intensity[ReferenceRenderer::numBlocks];
+
+	for (int8_t maxTexelError : maxTexelErrors)
+	for (uint8_t maxSplits : maxSpanSplits)
+	for (int8_t groundThreshold : groundThresholds)
+	for (int8_t cloudThreshold : cloudThresholds)
+	for (uint8_t blockShift : blockShifts)
+	for (int t = 0; t < numTilts; t++)
+	{
+		SweepResult result = {};
+		result.settings.interpThreshold = defaultInterpSettings.interpThreshold;
+		result.settings.groundThreshold = fixed8_t::FromRaw(groundThreshold);
+		result.settings.cloudThreshold = fixed8_t::FromRaw(cloudThreshold);
+		result.settings.blockShift = blockShift;
+		result.settings.cameraTilt = cameraTilts[t];
+		result.settings.maxTexelError = fixed8_t::FromRaw(maxTexelError);
+		result.settings.maxSpanSplits = maxSplits;
+		interpSettings = result.settings;
+
+		for (size_t p = 0; p < poses.size(); p++)
+		{
+			ApplyPose(poses[p]);
+			HeadlessPlatform::ClearScreen();
+			OpCounters::Reset();
+			GameDrawInterp();
+
+			uint32_t cycles = OpCounters::EstimateCycles();
+			result.meanCycles += cycles;
+			result.maxCycles = std::max(result.maxCycles, cycles);
+
+			ReferenceRenderer::ExtractIntensity(Platform::GetScreenBuffer(), intensity);
+			result.error += ReferenceRenderer::Compare(&references[(t * poses.size() + p) * ReferenceRenderer::numBlocks], intensity);
+		}
+
+		result.meanCycles /= poses.size();
+		results.push_back(result);
+	}
+
+	interpSettings = defaultInterpSettings;
+
+	// A configuration is on the frontier if nothing else is at least as cheap and as accurate, and better at one
+	for (SweepResult& result : results)
+	{
+		result.pareto = true;
+		for (const SweepResult& other : results)
+		{
+			bool noWorse = other.meanCycles <= result.meanCycles && MeanSquaredError(other.error) <= MeanSquaredError(result.error);
+			bool better = other.meanCycles < result.meanCycles || MeanSquaredError(other.error) < MeanSquaredError(result.error);
+			if (noWorse && better)
+			{
+				result.pareto = false;
+				break;
+			}
+		}
+	}
+
+	printf("%d configurations over %d poses (stride %d)\n\n", (int)results.size(), (int)poses.size(), stride);
+
+	std::vector<SweepResult> frontier;
+	std::copy_if(results.begin(), results.end(), std::back_inserter(frontier), [](const SweepResult& result) { return result.pareto; });
+	std::sort(frontier.begin(), frontier.end(), [](const SweepResult& a, const SweepResult& b) { return a.meanCycles < b.meanCycles; });
+
+	printf("Pareto frontier, cheapest first\n");
+	PrintResultHeader();
+	for (const SweepResult& result : frontier)
+	{
+		PrintResult(result);
+	}
+
+	for (const SweepResult& result : results)
+	{
+		if (IsDefault(result.settings) && !result.pareto)
+		{
+			printf("\nCurrent defaults, not on the frontier\n");
+			PrintResultHeader();
+			PrintResult(result);
+		}
+	}
+
+	if (csvFilename)
+	{
+		FILE* fs = fopen(csvFilename, "w");
+		if (!fs)
+		{
+			printf("Failed to open %s\n", csvFilename);
+			return 1;
+		}
+		fprintf(fs, "max_texel_error,max_span_splits,ground_threshold,cloud_threshold,block_size,camera_tilt,mean_cycles,max_cycles,mismatch_rate,mse,psnr,pareto\n");
+		for (const SweepResult& result : results)
+		{
+			fprintf(fs, "%f,%d,%d,%d,%d,%d,%f,%u,%f,%f,%f,%d\n",
+				result.settings.maxTexelError.rawValue / 64.0, result.settings.maxSpanSplits, result.settings.groundThreshold.rawValue, result.settings.cloudThreshold.rawValue,
+				1 << result.settings.blockShift, result.settings.cameraTilt, result.meanCycles, result.maxCycles,
+				result.error.MismatchRate(), MeanSquaredError(result.error), result.error.PSNR(), result.pareto ? 1 : 0);
+		}
+		fclose(fs);
+	}
+
+	return 0;
+}
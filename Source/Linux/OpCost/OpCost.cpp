@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "OpCounters.h"
+#include "HeadlessPlatform.h"
+#include "RenderHarness.h"
+
+// Estimates the AVR cycle cost of each renderer from hot path operation counts.
+// Must be linked against a game library built with OP_COUNTERS=1.
+// Usage: OpCost [-method NAME]
+
+#if !OP_COUNTERS
+#error OpCost requires OP_COUNTERS=1
+#endif
+
+constexpr int NumCounters = (int)OpCounter::NumCounters;
+
+struct CostStats
+{
+	double meanCounts[NumCounters];
+	double meanCycles;
+	uint32_t maxCycles;
+	int worstPoseIndex;
+};
+
+void PrintCost(const char* name, const CostStats& stats, const CameraPose* worstPose)
+{
+	printf("%s\n", name);
+	printf("  Mean: %8.0f cycles (%5.1f%% of frame budget)\n", stats.meanCycles, 100.0 * stats.meanCycles / OpCounters::cyclesPerFrame);
+	printf("  Max:  %8u cycles (%5.1f%% of frame budget)", stats.maxCycles, 100.0 * stats.maxCycles / OpCounters::cyclesPerFrame);
+	if (worstPose)
+	{
+		printf(" at pitch=%d roll=%d yaw=%d alt=%d", worstPose->pitch, worstPose->roll, worstPose->yaw, worstPose->altitude);
+	}
+	printf("\n");
+
+	printf("  %-24s %10s %8s %12s\n", "Operation", "Count", "Weight", "Cycles");
+	for (int n = 0; n < NumCounters; n++)
+	{
+		OpCounter op = (OpCounter)n;
+		if (stats.meanCounts[n] > 0)
+		{
+			printf("  %-24s %10.1f %8u %12.0f\n", OpCounters::GetName(op), stats.meanCounts[n], OpCounters::GetCycleWeight(op), stats.meanCounts[n] * OpCounters::GetCycleWeight(op));
+		}
+	}
+	printf("\n");
+}
+
+void MeasureMethod(const DrawMethod& method, const std::vector<CameraPose>& poses)
+{
+	CostStats stats = {};
+
+	for (unsigned n = 0; n < poses.size(); n++)
+	{
+		ApplyPose(poses[n]);
+		OpCounters::Reset();
+
+		method.draw();
+
+		uint32_t cycles = OpCounters::EstimateCycles();
+		stats.meanCycles += cycles;
+		if (cycles > stats.maxCycles)
+		{
+			stats.maxCycles = cycles;
+			stats.worstPoseIndex = n;
+		}
+		for (int i = 0; i < NumCounters; i++)
+		{
+			stats.meanCounts[i] += OpCounters::counts[i];
+		}
+	}
+
+	stats.meanCycles /= poses.size();
+	for (int i = 0; i < NumCounters; i++)
+	{
+		stats.meanCounts[i] /= poses.size();
+	}
+
+	PrintCost(method.name, stats, &poses[stats.worstPoseIndex]);
+}
+
+void MeasureTick()
+{
+	constexpr int numTicks = 256;
+	CostStats stats = {};
+
+	for (int n = 0; n < numTicks; n++)
+	{
+		OpCounters::Reset();
+		Game::Tick();
+
+		uint32_t cycles = OpCounters::EstimateCycles();
+		stats.meanCycles += cycles;
+		if (cycles > stats.maxCycles)
+		{
+			stats.maxCycles = cycles;
+		}
+		for (int i = 0; i < NumCounters; i++)
+		{
+			stats.meanCounts[i] += OpCounters::counts[i];
+		}
+	}
+
+	stats.meanCycles /= numTicks;
+	for (int i = 0; i < NumCounters; i++)
+	{
+		stats.meanCounts[i] /= numTicks;
+	}
+
+	PrintCost("Game::Tick", stats, nullptr);
+}
+
+int main(int argc, char* argv[])
+{
+	const char* methodFilter = nullptr;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-method") && n + 1 < argc)
+		{
+			methodFilter = argv[++n];
+		}
+		else
+		{
+			printf("Usage: %s [-method NAME]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	SeedRandom(0);
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+
+	std::vector<CameraPose> poses = BuildPoseSweep();
+
+	printf("%d poses, frame budget %u cycles at %d fps\n", (int)poses.size(), OpCounters::cyclesPerFrame, TARGET_FRAMERATE);
+	printf("Estimates only include counted operations so are a lower bound\n\n");
+
+	for (const DrawMethod& method : DrawMethods)
+	{
+		if (methodFilter && strcmp(methodFilter, method.name))
+		{
+			continue;
+		}
+
+		MeasureMethod(method, poses);
+	}
+
+	if (!methodFilter)
+	{
+		MeasureTick();
+	}
+
+	return 0;
+}
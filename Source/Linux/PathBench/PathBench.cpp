@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "OpCounters.h"
+#include "HeadlessPlatform.h"
+#include "StateHash.h"
+#include "RenderHarness.h"
+#include "FlightPath.h"
+
+// Flies keyframed camera paths through each renderer, reporting the estimated AVR cycles
+// from the op counters and the host time per frame. The path hash combines every frame's
+// sBuffer hash, so a change in it means the renderer output changed somewhere on the path.
+// Runs the built in paths unless given keyframe files with -path.
+// Must be linked against a game library built with OP_COUNTERS=1.
+// Usage: PathBench [-path FILE]... [-method NAME] [-csv FILE]
+
+#if !OP_COUNTERS
+#error PathBench requires OP_COUNTERS=1
+#endif
+
+struct PathResult
+{
+	double meanCycles;
+	uint32_t maxCycles;
+	int maxCyclesFrame;
+	double meanNs;
+	double maxNs;
+	uint32_t hash;
+};
+
+static PathResult RunPath(const FlightPath& path, const DrawMethod& method, FILE* csv)
+{
+	PathResult result = {};
+	result.hash = 2166136261u;
+	int numFrames = path.GetNumFrames();
+
+	for (int frame = 0; frame < numFrames; frame++)
+	{
+		// Simple resets the roll, so the path is applied again for every frame anyway
+		path.Apply(frame);
+		HeadlessPlatform::ClearScreen();
+		OpCounters::Reset();
+
+		auto startTime = std::chrono::steady_clock::now();
+		method.draw();
+		auto endTime = std::chrono::steady_clock::now();
+
+		uint32_t cycles = OpCounters::EstimateCycles();
+		double frameNs = std::chrono::duration<double, std::nano>(endTime - startTime).count();
+
+		result.meanCycles += cycles;
+		result.meanNs += frameNs;
+		if (cycles > result.maxCycles)
+		{
+			result.maxCycles = cycles;
+			result.maxCyclesFrame = frame;
+		}
+		if (frameNs > result.maxNs)
+		{
+			result.maxNs = frameNs;
+		}
+
+		result.hash = (result.hash ^ StateHash::HashScreen()) * 16777619u;
+
+		if (csv)
+		{
+			fprintf(csv, "%s,%s,%d,%d,%d,%d,%d,%d,%d,%u,%.0f\n", path.name, method.name, frame,
+				camera.position.x.rawValue, camera.position.y.rawValue, camera.position.z.rawValue,
+				camera.pitch, camera.roll, camera.yaw, cycles, frameNs);
+		}
+	}
+
+	if (numFrames > 0)
+	{
+		result.meanCycles /= numFrames;
+		result.meanNs /= numFrames;
+	}
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<FlightPath> paths;
+	const char* methodFilter = nullptr;
+	const char* csvFilename = nullptr;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-path") && n + 1 < argc)
+		{
+			FlightPath path;
+			if (!FlightPath::Load(argv[++n], path))
+				return 1;
+			paths.push_back(path);
+		}
+		else if (!strcmp(argv[n], "-method") && n + 1 < argc)
+		{
+			methodFilter = argv[++n];
+		}
+		else if (!strcmp(argv[n], "-csv") && n + 1 < argc)
+		{
+			csvFilename = argv[++n];
+		}
+		else
+		{
+			printf("Usage: %s [-path FILE]... [-method NAME] [-csv FILE]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (paths.empty())
+	{
+		paths = FlightPath::GetBuiltIn();
+	}
+
+	FILE* csv = nullptr;
+	if (csvFilename)
+	{
+		csv = fopen(csvFilename, "w");
+		if (!csv)
+		{
+			printf("Failed to open %s\n", csvFilename);
+			return 1;
+		}
+		fprintf(csv, "path,method,frame,x,y,z,pitch,roll,yaw,est_cycles,host_ns\n");
+	}
+
+	SeedRandom(0);
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+
+	printf("%-14s %-12s %7s %10s %10s %7s %10s %10s %10s\n", "Path", "Method", "Frames", "Mean cyc", "Max cyc", "@frame", "Mean ns", "Max ns", "Hash");
+
+	for (const FlightPath& path : paths)
+	{
+		for (const DrawMethod& method : DrawMethods)
+		{
+			if (methodFilter && strcmp(methodFilter, method.name))
+			{
+				continue;
+			}
+
+			PathResult result = RunPath(path, method, csv);
+			printf("%-14s %-12s %7d %10.0f %10u %7d %10.0f %10.0f   %08x\n", path.name, method.name, path.GetNumFrames(),
+				result.meanCycles, result.maxCycles, result.maxCyclesFrame, result.meanNs, result.maxNs, result.hash);
+		}
+	}
+
+	if (csv)
+	{
+		fclose(csv);
+	}
+
+	return 0;
+}
@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "HeadlessPlatform.h"
+#include "RenderHarness.h"
+
+#if defined(__has_include)
+#if __has_include(<sanitizer/common_interface_defs.h>)
+#include <sanitizer/common_interface_defs.h>
+#define HAS_SANITIZER_INTERFACE 1
+#endif
+#endif
+
+// Fuzz target that feeds arbitrary camera positions and angles into every draw method.
+// Built with address and undefined behaviour sanitizers, which abort on any write outside
+// sBuffer or arithmetic trap; the fuzzer itself also fails if a method writes below its viewport.
+// With clang the same target links against libFuzzer (POSE_FUZZ_LIBFUZZER), otherwise the
+// built in driver generates random inputs.
+// Usage: PoseFuzz [-iterations N] [-seed N] [-pose X Y Z PITCH ROLL YAW]
+// Positions are raw fixed16_t values.
+
+constexpr int screenBufferSize = DISPLAY_WIDTH * DISPLAY_HEIGHT / 8;
+constexpr uint8_t fillPattern = 0xa5;
+
+struct FuzzInput
+{
+	int16_t x, y, z;
+	angle_t pitch, roll, yaw;
+};
+
+static FuzzInput currentInput;
+static const DrawMethod* currentMethod;
+
+static void PrintCurrentInput()
+{
+	fprintf(stderr, "PoseFuzz failed: %s at -pose %d %d %d %d %d %d\n", currentMethod ? currentMethod->name : "(none)",
+		currentInput.x, currentInput.y, currentInput.z, currentInput.pitch, currentInput.roll, currentInput.yaw);
+}
+
+// Every method except Simple stops at the MFDs
+static int GetViewportHeight(const DrawMethod& method, int x)
+{
+	if (!strcmp(method.name, "Simple"))
+		return DISPLAY_HEIGHT;
+	return x < 40 || x >= DISPLAY_WIDTH - 40 ? DISPLAY_HEIGHT - 24 : DISPLAY_HEIGHT - 16;
+}
+
+static void ApplyInput(const FuzzInput& input)
+{
+	camera.position = Vector3s(fixed16_t::FromRaw(input.x), fixed16_t::FromRaw(input.y), fixed16_t::FromRaw(input.z));
+	camera.pitch = input.pitch;
+	camera.roll = input.roll;
+	camera.yaw = input.yaw;
+	camera.UpdateRotation();
+}
+
+static void RunInput(const FuzzInput& input)
+{
+	currentInput = input;
+
+	for (const DrawMethod& method : DrawMethods)
+	{
+		currentMethod = &method;
+
+		// Simple resets the roll, so the input is applied again for every method
+		ApplyInput(input);
+		memset(Platform::GetScreenBuffer(), fillPattern, screenBufferSize);
+		method.draw();
+
+		// The renderers write whole pages, so anything below the viewport must still be the fill pattern
+		const uint8_t* screenBuffer = Platform::GetScreenBuffer();
+		for (int x = 0; x < DISPLAY_WIDTH; x++)
+		{
+			for (int page = GetViewportHeight(method, x) / 8; page < DISPLAY_HEIGHT / 8; page++)
+			{
+				if (screenBuffer[page * DISPLAY_WIDTH + x] != fillPattern)
+				{
+					fprintf(stderr, "Write outside the viewport at column %d page %d\n", x, page);
+					PrintCurrentInput();
+					abort();
+				}
+			}
+		}
+	}
+
+	currentMethod = nullptr;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	FuzzInput input = {};
+	if (size < 9)
+		return 0;
+
+	input.x = (int16_t)(data[0] | (data[1] << 8));
+	input.y = (int16_t)(data[2] | (data[3] << 8));
+	input.z = (int16_t)(data[4] | (data[5] << 8));
+	input.pitch = data[6];
+	input.roll = data[7];
+	input.yaw = data[8];
+
+	RunInput(input);
+	return 0;
+}
+
+extern "C" int LLVMFuzzerInitialize(int*, char***)
+{
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+#if HAS_SANITIZER_INTERFACE
+	__sanitizer_set_death_callback(PrintCurrentInput);
+#endif
+	return 0;
+}
+
+#if !POSE_FUZZ_LIBFUZZER
+
+// Mostly uniform, with some inputs drawn from the edges where overflow is most likely
+static int16_t RandomCoordinate(std::mt19937& rng)
+{
+	static const int16_t edges[] = { INT16_MIN, INT16_MIN + 1, -1, 0, 1, -128 * 64, 128 * 64, INT16_MAX - 1, INT16_MAX };
+
+	switch (rng() % 4)
+	{
+	case 0:
+		return edges[rng() % (sizeof(edges) / sizeof(edges[0]))];
+	case 1:
+		return (int16_t)(rng() % 256 * 64);
+	default:
+		return (int16_t)rng();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	long iterations = 10000;
+	uint32_t seed = 1;
+	bool singlePose = false;
+	FuzzInput pose = {};
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-iterations") && n + 1 < argc)
+		{
+			iterations = atol(argv[++n]);
+		}
+		else if (!strcmp(argv[n], "-seed") && n + 1 < argc)
+		{
+			seed = (uint32_t)strtoul(argv[++n], nullptr, 0);
+		}
+		else if (!strcmp(argv[n], "-pose") && n + 6 < argc)
+		{
+			pose.x = (int16_t)atoi(argv[++n]);
+			pose.y = (int16_t)atoi(argv[++n]);
+			pose.z = (int16_t)atoi(argv[++n]);
+			pose.pitch = (angle_t)atoi(argv[++n]);
+			pose.roll = (angle_t)atoi(argv[++n]);
+			pose.yaw = (angle_t)atoi(argv[++n]);
+			singlePose = true;
+		}
+		else
+		{
+			printf("Usage: %s [-iterations N] [-seed N] [-pose X Y Z PITCH ROLL YAW]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	LLVMFuzzerInitialize(&argc, &argv);
+
+	if (singlePose)
+	{
+		RunInput(pose);
+		printf("No errors\n");
+		return 0;
+	}
+
+	std::mt19937 rng(seed);
+
+	for (long n = 0; n < iterations; n++)
+	{
+		FuzzInput input;
+		input.x = RandomCoordinate(rng);
+		input.y = RandomCoordinate(rng);
+		input.z = RandomCoordinate(rng);
+		input.pitch = (angle_t)rng();
+		input.roll = (angle_t)rng();
+		input.yaw = (angle_t)rng();
+		RunInput(input);
+	}
+
+	printf("%ld inputs with seed %u, no errors\n", iterations, seed);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "HeadlessPlatform.h"
+#include "RenderHarness.h"
+#include "ReferenceRenderer.h"
+#include "lodepng.h"
+
+// Compares each fixed point draw method against the double precision reference renderer.
+// Without a pose, runs the full pose sweep and reports the texel mismatch rate and PSNR of
+// the pre-dither intensity per method. With a pose, reports that pose only and can write
+// <prefix>_<method>.png with the reference, the method's output and the difference.
+// Usage: ReferenceCompare [-method NAME] [-pitch N] [-roll N] [-yaw N] [-alt N] [-o PREFIX]
+
+struct MethodResult
+{
+	FrameError total;
+	double worstMismatchRate;
+	CameraPose worstPose;
+};
+
+static ReferenceView GetReferenceView(const DrawMethod& method, const CameraPose& pose)
+{
+	ReferenceView view;
+	view.pitch = pose.pitch;
+	view.roll = pose.roll;
+	view.yaw = pose.yaw;
+	view.x = camera.position.x.rawValue / 64.0;
+	view.y = camera.position.y.rawValue / 64.0;
+	view.z = camera.position.z.rawValue / 64.0;
+	view.tilt = method.tilt;
+	view.rowOffset = method.rowOffset;
+	return view;
+}
+
+static FrameError CompareMethod(const DrawMethod& method, const CameraPose& pose, uint8_t* outReference, uint8_t* outIntensity)
+{
+	// Simple resets the roll, so the pose is applied again for every method
+	ApplyPose(pose);
+	ReferenceRenderer::Render(GetReferenceView(method, pose), outReference);
+
+	HeadlessPlatform::ClearScreen();
+	method.draw();
+	ReferenceRenderer::ExtractIntensity(Platform::GetScreenBuffer(), outIntensity);
+
+	return ReferenceRenderer::Compare(outReference, outIntensity);
+}
+
+static void WriteComparison(const std::string& path, const uint8_t* reference, const uint8_t* intensity)
+{
+	// Reference, method output and absolute difference stacked vertically
+	constexpr int imageHeight = DISPLAY_HEIGHT * 3 + 2;
+	std::vector<uint8_t> image(DISPLAY_WIDTH * imageHeight * 4, 128);
+	uint8_t dithered[DISPLAY_WIDTH * DISPLAY_HEIGHT / 8] = {};
+	ReferenceRenderer::Dither(reference, dithered);
+
+	for (int y = 0; y < DISPLAY_HEIGHT; y++)
+	{
+		for (int x = 0; x < DISPLAY_WIDTH; x++)
+		{
+			int block = (y / 2) * ReferenceRenderer::blocksWide + x / 2;
+			bool inViewport = ReferenceRenderer::IsInViewport(x / 2, y / 2);
+			uint8_t referencePixel = dithered[(y / 8) * DISPLAY_WIDTH + x] & (1 << (y & 7)) ? 255 : 0;
+			uint8_t methodPixel = HeadlessPlatform::GetPixel(x, y) ? 255 : 0;
+			int difference = abs((int)intensity[block] - (int)reference[block]);
+
+			uint8_t* pixel = &image[(y * DISPLAY_WIDTH + x) * 4];
+			pixel[0] = pixel[1] = pixel[2] = referencePixel;
+			pixel[3] = 255;
+
+			pixel = &image[((y + DISPLAY_HEIGHT + 1) * DISPLAY_WIDTH + x) * 4];
+			pixel[0] = pixel[1] = pixel[2] = methodPixel;
+			pixel[3] = 255;
+
+			// Red for brighter than the reference, blue for darker
+			pixel = &image[((y + (DISPLAY_HEIGHT + 1) * 2) * DISPLAY_WIDTH + x) * 4];
+			uint8_t level = (uint8_t)(difference * 255 / ReferenceRenderer::maxIntensity);
+			bool brighter = intensity[block] > reference[block];
+			pixel[0] = inViewport && brighter ? level : 0;
+			pixel[1] = inViewport ? 0 : 64;
+			pixel[2] = inViewport && !brighter ? level : 0;
+			pixel[3] = 255;
+		}
+	}
+
+	unsigned error = lodepng::encode(path, image, DISPLAY_WIDTH, imageHeight);
+	if (error)
+	{
+		printf("%s : encoder error %u: %s\n", path.c_str(), error, lodepng_error_text(error));
+	}
+	else
+	{
+		printf("Wrote %s\n", path.c_str());
+	}
+}
+
+static void PrintResultHeader()
+{
+	printf("%-12s %10s %10s %9s\n", "method", "mismatch", "PSNR dB", "blocks");
+}
+
+static void PrintResult(const char* name, const FrameError& error)
+{
+	printf("%-12s %9.2f%% %10.2f %9d\n", name, error.MismatchRate() * 100.0, error.PSNR(), error.numBlocks);
+}
+
+int main(int argc, char* argv[])
+{
+	const char* methodName = nullptr;
+	const char* prefix = nullptr;
+	CameraPose pose = { 0, 0, 0, 75 };
+	bool singlePose = false;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-method") && n + 1 < argc)
+			methodName = argv[++n];
+		else if (!strcmp(argv[n], "-pitch") && n + 1 < argc)
+			pose.pitch = (angle_t)atoi(argv[++n]), singlePose = true;
+		else if (!strcmp(argv[n], "-roll") && n + 1 < argc)
+			pose.roll = (angle_t)atoi(argv[++n]), singlePose = true;
+		else if (!strcmp(argv[n], "-yaw") && n + 1 < argc)
+			pose.yaw = (angle_t)atoi(argv[++n]), singlePose = true;
+		else if (!strcmp(argv[n], "-alt") && n + 1 < argc)
+			pose.altitude = (int16_t)atoi(argv[++n]), singlePose = true;
+		else if (!strcmp(argv[n], "-o") && n + 1 < argc)
+			prefix = argv[++n], singlePose = true;
+		else
+		{
+			printf("Usage: %s [-method NAME] [-pitch N] [-roll N] [-yaw N] [-alt N] [-o PREFIX]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<const DrawMethod*> methods;
+	for (const DrawMethod& method : DrawMethods)
+	{
+		if (!methodName || !strcmp(method.name, methodName))
+			methods.push_back(&method);
+	}
+	if (methods.empty())
+	{
+		printf("Unknown draw method %s\n", methodName);
+		return 1;
+	}
+
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+
+	uint8_t reference[ReferenceRenderer::numBlocks];
+	uint8_t intensity[ReferenceRenderer::numBlocks];
+
+	if (singlePose)
+	{
+		printf("Pitch=%d roll=%d yaw=%d alt=%d\n\n", pose.pitch, pose.roll, pose.yaw, pose.altitude);
+		PrintResultHeader();
+
+		for (const DrawMethod* method : methods)
+		{
+			FrameError error = CompareMethod(*method, pose, reference, intensity);
+			PrintResult(method->name, error);
+
+			if (prefix)
+			{
+				WriteComparison(std::string(prefix) + "_" + method->name + ".png", reference, intensity);
+			}
+		}
+		return 0;
+	}
+
+	std::vector<CameraPose> poses = BuildPoseSweep();
+	printf("%d poses\n\n", (int)poses.size());
+	PrintResultHeader();
+
+	for (const DrawMethod* method : methods)
+	{
+		MethodResult result = {};
+
+		for (const CameraPose& sweepPose : poses)
+		{
+			FrameError error = CompareMethod(*method, sweepPose, reference, intensity);
+			result.total += error;
+
+			if (error.MismatchRate() > result.worstMismatchRate)
+			{
+				result.worstMismatchRate = error.MismatchRate();
+				result.worstPose = sweepPose;
+			}
+		}
+
+		PrintResult(method->name, result.total);
+		printf("%-12s worst %.2f%% at pitch=%d roll=%d yaw=%d alt=%d\n", "", result.worstMismatchRate * 100.0,
+			result.worstPose.pitch, result.worstPose.roll, result.worstPose.yaw, result.worstPose.altitude);
+	}
+
+	return 0;
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "Defines.h"
+#include "Replay.h"
+#include "DefaultReplay.h"
+
+// Prints the contents of an input replay and converts it for other builds: -header writes a
+// PROGMEM array for the device (REPLAY_PLAYBACK) or SimFirmware (SIM_REPLAY_HEADER), and -o
+// writes a replay file. -default reads the built in SimFirmware flight instead of a file,
+// so the host can fly the same replay with FlightSimHeadless -replay.
+// Usage: ReplayTool (FILE | -default) [-header OUT.h] [-o OUT.mfr] [-runs]
+
+static const char* GetInputName(uint8_t input, char* outName)
+{
+	static const char inputChars[] = "LRUDAB";
+	int length = 0;
+
+	for (int n = 0; n < 6; n++)
+	{
+		if (input & (1 << n))
+			outName[length++] = inputChars[n];
+	}
+	if (!length)
+		outName[length++] = '-';
+	outName[length] = '\0';
+	return outName;
+}
+
+static int16_t ReadRaw(const std::vector<uint8_t>& data, int offset)
+{
+	return (int16_t)(data[offset] | (data[offset + 1] << 8));
+}
+
+static bool WriteHeader(const char* filename, const char* source, const std::vector<uint8_t>& data)
+{
+	FILE* fs = fopen(filename, "w");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", filename);
+		return false;
+	}
+
+	fprintf(fs, "#pragma once\n\n");
+	fprintf(fs, "#include <stdint.h>\n#include \"Defines.h\"\n\n");
+	fprintf(fs, "// Input replay written by ReplayTool from %s\n", source);
+	fprintf(fs, "const uint8_t replayData[] PROGMEM =\n{\n\t");
+	for (size_t n = 0; n < data.size(); n++)
+	{
+		// Header on the first line, then 8 runs per line
+		if (n >= Replay::headerSize && (n - Replay::headerSize) % 16 == 0)
+			fprintf(fs, "\n\t");
+		else if (n > 0)
+			fprintf(fs, " ");
+		fprintf(fs, "0x%02x%s", data[n], n + 1 < data.size() ? "," : "");
+	}
+	fprintf(fs, "\n};\n");
+
+	fclose(fs);
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* inputFilename = nullptr;
+	const char* headerFilename = nullptr;
+	const char* outputFilename = nullptr;
+	bool useDefault = false;
+	bool printRuns = false;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-default"))
+			useDefault = true;
+		else if (!strcmp(argv[n], "-header") && n + 1 < argc)
+			headerFilename = argv[++n];
+		else if (!strcmp(argv[n], "-o") && n + 1 < argc)
+			outputFilename = argv[++n];
+		else if (!strcmp(argv[n], "-runs"))
+			printRuns = true;
+		else if (!inputFilename && argv[n][0] != '-')
+			inputFilename = argv[n];
+		else
+		{
+			inputFilename = nullptr;
+			useDefault = false;
+			break;
+		}
+	}
+
+	if (!inputFilename == !useDefault)
+	{
+		printf("Usage: %s (FILE | -default) [-header OUT.h] [-o OUT.mfr] [-runs]\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<uint8_t> data;
+	if (useDefault)
+	{
+		data.assign(replayData, replayData + sizeof(replayData));
+		inputFilename = "DefaultReplay.h";
+	}
+	else if (!Replay::Load(inputFilename, data))
+	{
+		return 1;
+	}
+
+	if (data[0] != 'M' || data[1] != 'F' || data[2] != 'R' || data[3] != Replay::version)
+	{
+		printf("%s is not a version %d replay\n", inputFilename, Replay::version);
+		return 1;
+	}
+
+	int numRuns = (int)(data.size() - Replay::headerSize) / 2 - 1;
+	printf("Seed:     %u\n", (uint16_t)ReadRaw(data, 4));
+	printf("Position: %d %d %d (raw)\n", ReadRaw(data, 6), ReadRaw(data, 8), ReadRaw(data, 10));
+	printf("Angles:   pitch=%d roll=%d yaw=%d\n", data[12], data[13], data[14]);
+	printf("Ticks:    %u in %d runs\n", Replay::GetNumTicks(data.data()), numRuns);
+
+	if (printRuns)
+	{
+		uint32_t tick = 0;
+		char inputName[8];
+		for (int run = 0; run < numRuns; run++)
+		{
+			uint8_t ticks = data[Replay::headerSize + run * 2];
+			uint8_t input = data[Replay::headerSize + run * 2 + 1];
+			printf("  %6u +%-3u %s\n", tick, ticks, GetInputName(input, inputName));
+			tick += ticks;
+		}
+	}
+
+	if (headerFilename && WriteHeader(headerFilename, inputFilename, data))
+	{
+		printf("Wrote %s\n", headerFilename);
+	}
+	if (outputFilename && Replay::Save(outputFilename, data))
+	{
+		printf("Wrote %s\n", outputFilename);
+	}
+
+	return 0;
+}
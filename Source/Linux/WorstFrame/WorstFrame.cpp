@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "OpCounters.h"
+#include "HeadlessPlatform.h"
+#include "RenderHarness.h"
+
+// Searches camera pose and altitude for the frames that cost each draw method the most
+// estimated AVR cycles, as an upper bound to budget against rather than an average.
+// Starts from the worst poses of the pose sweep plus random poses, then hill climbs each,
+// trying single axis steps that shrink as the search stops finding more expensive frames.
+// Costs come from the op counter model, so check the final poses under simavr before relying
+// on the absolute cycle counts. -o writes the poses as a FlightPath keyframe file.
+// Must be linked against a game library built with OP_COUNTERS=1.
+// Usage: WorstFrame [-method NAME] [-restarts N] [-steps N] [-seed N] [-o FILE]
+
+#if !OP_COUNTERS
+#error WorstFrame requires OP_COUNTERS=1
+#endif
+
+// Same limits as Game::Tick
+constexpr int16_t minAltitude = 1 * 64;
+constexpr int16_t maxAltitude = 120 * 64;
+
+struct SearchPose
+{
+	int16_t x, y, z;
+	angle_t pitch, roll, yaw;
+};
+
+struct SearchResult
+{
+	SearchPose pose;
+	uint32_t cycles;
+};
+
+static void ApplySearchPose(const SearchPose& pose)
+{
+	camera.position = Vector3s(fixed16_t::FromRaw(pose.x), fixed16_t::FromRaw(pose.y), fixed16_t::FromRaw(pose.z));
+	camera.pitch = pose.pitch;
+	camera.roll = pose.roll;
+	camera.yaw = pose.yaw;
+	camera.UpdateRotation();
+}
+
+static uint32_t MeasurePose(const DrawMethod& method, const SearchPose& pose)
+{
+	// Simple resets the roll, so the pose is applied for every measurement
+	ApplySearchPose(pose);
+	OpCounters::Reset();
+	method.draw();
+	return OpCounters::EstimateCycles();
+}
+
+static SearchPose RandomPose(std::mt19937& rng)
+{
+	SearchPose pose;
+	pose.x = (int16_t)rng();
+	pose.y = (int16_t)(minAltitude + rng() % (maxAltitude - minAltitude + 1));
+	pose.z = (int16_t)rng();
+	pose.pitch = (angle_t)rng();
+	pose.roll = (angle_t)rng();
+	pose.yaw = (angle_t)rng();
+	return pose;
+}
+
+// One axis moved by up to +/- scale, where scale is in angle units and 1/4 world units
+static SearchPose Neighbour(const SearchPose& pose, int scale, std::mt19937& rng)
+{
+	SearchPose result = pose;
+	int delta = (int)(rng() % scale) + 1;
+	if (rng() & 1)
+		delta = -delta;
+
+	switch (rng() % 6)
+	{
+	case 0:
+		result.x = (int16_t)(result.x + delta * 16);
+		break;
+	case 1:
+	{
+		int y = result.y + delta * 16;
+		result.y = (int16_t)(y < minAltitude ? minAltitude : y > maxAltitude ? maxAltitude : y);
+		break;
+	}
+	case 2:
+		result.z = (int16_t)(result.z + delta * 16);
+		break;
+	case 3:
+		result.pitch = (angle_t)(result.pitch + delta);
+		break;
+	case 4:
+		result.roll = (angle_t)(result.roll + delta);
+		break;
+	default:
+		result.yaw = (angle_t)(result.yaw + delta);
+		break;
+	}
+	return result;
+}
+
+static SearchResult HillClimb(const DrawMethod& method, const SearchPose& start, int steps, std::mt19937& rng)
+{
+	constexpr int maxScale = 32;
+	constexpr int stallsPerScale = 24;
+
+	SearchResult best = { start, MeasurePose(method, start) };
+	int scale = maxScale;
+	int stalls = 0;
+
+	for (int step = 0; step < steps && scale > 0; step++)
+	{
+		SearchPose candidate = Neighbour(best.pose, scale, rng);
+		uint32_t cycles = MeasurePose(method, candidate);
+
+		// Equal costs are accepted so the search can walk along plateaus
+		if (cycles >= best.cycles)
+		{
+			if (cycles > best.cycles)
+				stalls = 0;
+			best.pose = candidate;
+			best.cycles = cycles;
+		}
+		else if (++stalls >= stallsPerScale)
+		{
+			scale /= 2;
+			stalls = 0;
+		}
+	}
+
+	return best;
+}
+
+static SearchResult SearchMethod(const DrawMethod& method, const std::vector<CameraPose>& sweep, int restarts, int steps, std::mt19937& rng)
+{
+	// Seed with the most expensive sweep poses, which are already near the worst case
+	std::vector<SearchResult> starts;
+	for (const CameraPose& sweepPose : sweep)
+	{
+		// ApplyPose's x and z of 64 * 16 wrap to 0
+		SearchPose pose = { 0, (int16_t)(sweepPose.altitude * 64), 0, sweepPose.pitch, sweepPose.roll, sweepPose.yaw };
+		starts.push_back({ pose, MeasurePose(method, pose) });
+	}
+	std::sort(starts.begin(), starts.end(), [](const SearchResult& a, const SearchResult& b) { return a.cycles > b.cycles; });
+	starts.resize(restarts / 2 < (int)starts.size() ? restarts / 2 : starts.size());
+
+	while ((int)starts.size() < restarts)
+	{
+		SearchPose pose = RandomPose(rng);
+		starts.push_back({ pose, 0 });
+	}
+
+	SearchResult worst = {};
+	for (const SearchResult& start : starts)
+	{
+		SearchResult result = HillClimb(method, start.pose, steps, rng);
+		if (result.cycles > worst.cycles)
+			worst = result;
+	}
+	return worst;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* methodFilter = nullptr;
+	const char* outputFilename = nullptr;
+	int restarts = 32;
+	int steps = 400;
+	uint32_t seed = 1;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-method") && n + 1 < argc)
+			methodFilter = argv[++n];
+		else if (!strcmp(argv[n], "-restarts") && n + 1 < argc)
+			restarts = atoi(argv[++n]);
+		else if (!strcmp(argv[n], "-steps") && n + 1 < argc)
+			steps = atoi(argv[++n]);
+		else if (!strcmp(argv[n], "-seed") && n + 1 < argc)
+			seed = (uint32_t)strtoul(argv[++n], nullptr, 0);
+		else if (!strcmp(argv[n], "-o") && n + 1 < argc)
+			outputFilename = argv[++n];
+		else
+		{
+			printf("Usage: %s [-method NAME] [-restarts N] [-steps N] [-seed N] [-o FILE]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (restarts < 1 || steps < 0)
+	{
+		printf("Need at least one restart\n");
+		return 1;
+	}
+
+	FILE* fs = nullptr;
+	if (outputFilename)
+	{
+		fs = fopen(outputFilename, "w");
+		if (!fs)
+		{
+			printf("Failed to open %s\n", outputFilename);
+			return 1;
+		}
+		fprintf(fs, "# Worst case poses found by WorstFrame, one per draw method, as FlightPath keyframes\n");
+		fprintf(fs, "# frame x y z pitch roll yaw\n");
+	}
+
+	SeedRandom(0);
+	HeadlessPlatform::ClearScreen();
+	Game::Init();
+
+	std::mt19937 rng(seed);
+	std::vector<CameraPose> sweep = BuildPoseSweep();
+	int frame = 0;
+
+	printf("%d restarts of %d steps, frame budget %u cycles\n\n", restarts, steps, OpCounters::cyclesPerFrame);
+	printf("%-12s %10s %7s   %s\n", "Method", "Worst cyc", "Budget", "Pose (raw x y z, pitch roll yaw)");
+
+	for (const DrawMethod& method : DrawMethods)
+	{
+		if (methodFilter && strcmp(methodFilter, method.name))
+		{
+			continue;
+		}
+
+		SearchResult worst = SearchMethod(method, sweep, restarts, steps, rng);
+		const SearchPose& pose = worst.pose;
+
+		printf("%-12s %10u %6.1f%%   -pose %d %d %d %d %d %d\n", method.name, worst.cycles,
+			100.0 * worst.cycles / OpCounters::cyclesPerFrame, pose.x, pose.y, pose.z, pose.pitch, pose.roll, pose.yaw);
+
+		if (fs)
+		{
+			fprintf(fs, "%d %.4f %.4f %.4f %d %d %d # %s %u cycles\n", frame++, pose.x / 64.0, pose.y / 64.0, pose.z / 64.0,
+				pose.pitch, pose.roll, pose.yaw, method.name, worst.cycles);
+		}
+	}
+
+	if (fs)
+	{
+		fclose(fs);
+		printf("\nWrote poses to %s\n", outputFilename);
+	}
+
+	return 0;
+}
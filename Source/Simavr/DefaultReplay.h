@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+#include "Replay.h"
+
+// Default SimFirmware flight, in the Replay format. Exercises level flight, banked turns
+// both ways, climbs and dives and a full roll, then switches draw method.
+// Starts from the Game::Init camera, where x and z wrap to 0.
+const uint8_t replayData[] PROGMEM =
+{
+	'M', 'F', 'R', Replay::version,
+	0, 0,						// seed
+	0, 0, 0xc0, 0x12, 0, 0,		// camera position
+	0, 0, 0,					// pitch, roll, yaw
+	30, 0,
+	16, INPUT_LEFT,
+	60, 0,
+	32, INPUT_RIGHT,
+	60, 0,
+	16, INPUT_LEFT,
+	24, INPUT_UP,
+	30, 0,
+	48, INPUT_DOWN,
+	30, 0,
+	24, INPUT_UP,
+	128, INPUT_LEFT,
+	30, INPUT_B,
+	30, 0,
+	0, 0
+};
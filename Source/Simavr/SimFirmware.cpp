@@ -0,0 +1,139 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "Defines.h"
+#include "Game.h"
+#include "Platform.h"
+#include "FixedMath.h"
+#include "MemoryStats.h"
+#include "Replay.h"
+#include "StateHash.h"
+#include "SimMarkers.h"
+
+// ATmega32u4 firmware for cycle measurement under simavr. Replaces the Arduboy2 layer
+// with a bare screen buffer and plays back an input replay, marking the start and end of
+// Game::Tick and Game::Draw for SimRunner.
+// Built a second time with MEMORY_STATS=1, which reports SRAM usage once the replay finishes.
+// SIM_HASHES=1 also sends a StateHash of the game state after every tick, and SIM_HASHES=2
+// the screen after every draw, for DeterminismCheck. Hashing is outside the marked stages.
+
+#ifndef SIM_HASHES
+#define SIM_HASHES 0
+#endif
+
+uint8_t sBuffer[DISPLAY_WIDTH * DISPLAY_HEIGHT / 8];
+static uint8_t currentInput = 0;
+
+// Replay to fly, either DefaultReplay.h or one written by ReplayTool -header
+#ifndef SIM_REPLAY_HEADER
+#define SIM_REPLAY_HEADER "DefaultReplay.h"
+#endif
+#include SIM_REPLAY_HEADER
+
+uint8_t Platform::GetInput()
+{
+	return currentInput;
+}
+
+uint8_t* Platform::GetScreenBuffer()
+{
+	return sBuffer;
+}
+
+void Platform::PutPixel(uint8_t x, uint8_t y, uint8_t colour)
+{
+	if (x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT)
+	{
+		return;
+	}
+
+	uint16_t row_offset;
+	uint8_t bit;
+
+	bit = 1 << (y & 7);
+	row_offset = (y & 0xF8) * DISPLAY_WIDTH / 8 + x;
+	uint8_t data = sBuffer[row_offset] | bit;
+	if (!colour) data ^= bit;
+	sBuffer[row_offset] = data;
+}
+
+void Platform::SetLED(uint8_t, uint8_t, uint8_t)
+{
+}
+
+void Platform::PlaySound(const uint16_t*)
+{
+}
+
+bool Platform::IsAudioEnabled()
+{
+	return false;
+}
+
+void Platform::SetAudioEnabled(bool)
+{
+}
+
+void Platform::ExpectLoadDelay()
+{
+}
+
+#if SIM_HASHES
+static void SendHash(uint8_t marker, uint32_t hash)
+{
+	GPIOR0 = marker;
+	for (uint8_t n = 0; n < 4; n++)
+	{
+		GPIOR0 = (uint8_t)hash;
+		hash >>= 8;
+	}
+}
+#endif
+
+#if MEMORY_STATS
+static void WriteSimSerial(char c)
+{
+	GPIOR2 = c;
+}
+#endif
+
+int main()
+{
+	Game::Init();
+	Replay::BeginPlayback(replayData);
+
+	while (Replay::IsPlaying())
+	{
+		currentInput = Replay::NextInput();
+		GPIOR1 = currentInput;
+
+		GPIOR0 = SIM_MARKER_TICK_BEGIN;
+		Game::Tick();
+		GPIOR0 = SIM_MARKER_TICK_END;
+
+#if SIM_HASHES
+		SendHash(SIM_MARKER_STATE_HASH, StateHash::HashState());
+#endif
+
+		GPIOR0 = SIM_MARKER_DRAW_BEGIN;
+		Game::Draw();
+		GPIOR0 = SIM_MARKER_DRAW_END;
+
+#if SIM_HASHES >= 2
+		SendHash(SIM_MARKER_SCREEN_HASH, StateHash::HashScreen());
+#endif
+	}
+
+#if MEMORY_STATS
+	MemoryStats::Report(WriteSimSerial);
+#endif
+
+	GPIOR0 = SIM_MARKER_DONE;
+
+	// Sleeping with interrupts disabled stops simavr
+	cli();
+	sleep_enable();
+	sleep_cpu();
+
+	return 0;
+}
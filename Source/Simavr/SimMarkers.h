@@ -0,0 +1,25 @@
+#pragma once
+
+// Protocol between the simavr firmware and SimRunner.
+// The firmware writes markers to GPIOR0 around each stage of the frame; SimRunner traps
+// the writes and samples the simulated cycle counter. Each marker write is a single OUT
+// instruction so adds 1 cycle to the measured stage.
+
+// GPIOR0 / GPIOR1 addresses in the ATmega32u4 data space
+#define SIM_MARKER_REGISTER 0x3E
+#define SIM_INPUT_REGISTER 0x4A
+
+// GPIOR2: text written a character at a time, echoed by SimRunner in place of a serial port.
+// Used for the MEMORY_STATS report.
+#define SIM_SERIAL_REGISTER 0x4B
+
+#define SIM_MARKER_TICK_BEGIN 1
+#define SIM_MARKER_TICK_END 2
+#define SIM_MARKER_DRAW_BEGIN 3
+#define SIM_MARKER_DRAW_END 4
+// Followed by the four bytes of a StateHash value, low byte first, on the same register
+#define SIM_MARKER_STATE_HASH 5
+#define SIM_MARKER_SCREEN_HASH 6
+#define SIM_MARKER_DONE 0xFF
+
+#define SIM_CPU_FREQUENCY 16000000
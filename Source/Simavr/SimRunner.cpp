@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include "SimMarkers.h"
+#include "Defines.h"
+
+// Runs SimFirmware.elf under simavr and logs exact Game::Tick / Game::Draw cycle counts per frame.
+// Text the firmware writes to SIM_SERIAL_REGISTER is echoed to stdout, so running
+// SimFirmwareMemory.elf also prints its SRAM usage report.
+// Firmware built with SIM_HASHES sends state and screen hashes, which -hashes writes out for DeterminismCheck.
+// Usage: SimRunner firmware.elf [-o cycles.csv] [-hashes hashes.txt]
+
+struct FrameCycles
+{
+	uint8_t input;
+	uint32_t tickCycles;
+	uint32_t drawCycles;
+};
+
+struct FrameHash
+{
+	uint32_t frame;
+	uint8_t marker;
+	uint32_t hash;
+};
+
+struct SimState
+{
+	avr_cycle_count_t stageStart;
+	FrameCycles current;
+	std::vector<FrameCycles> frames;
+	bool isDone;
+
+	// Hash currently being received after a hash marker
+	FrameHash pendingHash;
+	uint8_t pendingHashBytes;
+	std::vector<FrameHash> hashes;
+};
+
+static void OnMarkerWrite(avr_t* avr, avr_io_addr_t, uint8_t value, void* param)
+{
+	SimState* state = (SimState*)param;
+
+	if (state->pendingHashBytes)
+	{
+		state->pendingHash.hash |= (uint32_t)value << (8 * (4 - state->pendingHashBytes));
+		if (--state->pendingHashBytes == 0)
+		{
+			state->hashes.push_back(state->pendingHash);
+		}
+		return;
+	}
+
+	switch (value)
+	{
+	case SIM_MARKER_STATE_HASH:
+	case SIM_MARKER_SCREEN_HASH:
+		// The state hash comes after the tick and the screen hash after the draw has been logged
+		state->pendingHash.frame = (uint32_t)state->frames.size() - (value == SIM_MARKER_SCREEN_HASH ? 1 : 0);
+		state->pendingHash.marker = value;
+		state->pendingHash.hash = 0;
+		state->pendingHashBytes = 4;
+		break;
+	case SIM_MARKER_TICK_BEGIN:
+	case SIM_MARKER_DRAW_BEGIN:
+		state->stageStart = avr->cycle;
+		break;
+	case SIM_MARKER_TICK_END:
+		state->current.tickCycles = (uint32_t)(avr->cycle - state->stageStart);
+		break;
+	case SIM_MARKER_DRAW_END:
+		state->current.drawCycles = (uint32_t)(avr->cycle - state->stageStart);
+		state->frames.push_back(state->current);
+		break;
+	case SIM_MARKER_DONE:
+		state->isDone = true;
+		break;
+	}
+}
+
+static void OnInputWrite(avr_t*, avr_io_addr_t, uint8_t value, void* param)
+{
+	SimState* state = (SimState*)param;
+	state->current.input = value;
+}
+
+static void OnSerialWrite(avr_t*, avr_io_addr_t, uint8_t value, void*)
+{
+	putchar(value);
+}
+
+int main(int argc, char* argv[])
+{
+	const char* firmwarePath = nullptr;
+	const char* outputPath = "cycles.csv";
+	const char* hashesPath = nullptr;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-o") && n + 1 < argc)
+		{
+			outputPath = argv[++n];
+		}
+		else if (!strcmp(argv[n], "-hashes") && n + 1 < argc)
+		{
+			hashesPath = argv[++n];
+		}
+		else if (!firmwarePath && argv[n][0] != '-')
+		{
+			firmwarePath = argv[n];
+		}
+		else
+		{
+			firmwarePath = nullptr;
+			break;
+		}
+	}
+
+	if (!firmwarePath)
+	{
+		printf("Usage: %s firmware.elf [-o cycles.csv] [-hashes hashes.txt]\n", argv[0]);
+		return 1;
+	}
+
+	elf_firmware_t firmware = {};
+	if (elf_read_firmware(firmwarePath, &firmware) != 0)
+	{
+		printf("Failed to load firmware %s\n", firmwarePath);
+		return 1;
+	}
+
+	avr_t* avr = avr_make_mcu_by_name("atmega32u4");
+	if (!avr)
+	{
+		printf("simavr has no atmega32u4 core\n");
+		return 1;
+	}
+
+	avr_init(avr);
+	avr->frequency = SIM_CPU_FREQUENCY;
+	avr_load_firmware(avr, &firmware);
+
+	SimState state = {};
+	avr_register_io_write(avr, SIM_MARKER_REGISTER, OnMarkerWrite, &state);
+	avr_register_io_write(avr, SIM_INPUT_REGISTER, OnInputWrite, &state);
+	avr_register_io_write(avr, SIM_SERIAL_REGISTER, OnSerialWrite, nullptr);
+
+	int cpuState = cpu_Running;
+	while (!state.isDone && cpuState != cpu_Done && cpuState != cpu_Crashed)
+	{
+		cpuState = avr_run(avr);
+	}
+
+	if (cpuState == cpu_Crashed)
+	{
+		printf("Firmware crashed at PC 0x%04x after %d frames\n", avr->pc, (int)state.frames.size());
+	}
+
+	FILE* fs = fopen(outputPath, "w");
+	if (!fs)
+	{
+		printf("Failed to open %s\n", outputPath);
+		return 1;
+	}
+
+	constexpr uint32_t frameBudget = SIM_CPU_FREQUENCY / TARGET_FRAMERATE;
+	uint64_t totalTick = 0, totalDraw = 0;
+	uint32_t maxTick = 0, maxDraw = 0;
+	int overBudget = 0;
+
+	fprintf(fs, "frame,input,tick_cycles,draw_cycles,total_cycles\n");
+	for (unsigned n = 0; n < state.frames.size(); n++)
+	{
+		const FrameCycles& frame = state.frames[n];
+		uint32_t total = frame.tickCycles + frame.drawCycles;
+		fprintf(fs, "%u,%u,%u,%u,%u\n", n, frame.input, frame.tickCycles, frame.drawCycles, total);
+
+		totalTick += frame.tickCycles;
+		totalDraw += frame.drawCycles;
+		if (frame.tickCycles > maxTick)
+			maxTick = frame.tickCycles;
+		if (frame.drawCycles > maxDraw)
+			maxDraw = frame.drawCycles;
+		if (total > frameBudget)
+			overBudget++;
+	}
+
+	fclose(fs);
+
+	if (hashesPath)
+	{
+		FILE* hashFs = fopen(hashesPath, "w");
+		if (!hashFs)
+		{
+			printf("Failed to open %s\n", hashesPath);
+			return 1;
+		}
+		fprintf(hashFs, "# frame stage hash\n");
+		for (const FrameHash& hash : state.hashes)
+		{
+			fprintf(hashFs, "%u %s %08x\n", hash.frame, hash.marker == SIM_MARKER_STATE_HASH ? "state" : "screen", hash.hash);
+		}
+		fclose(hashFs);
+		printf("Wrote %d hashes to %s\n", (int)state.hashes.size(), hashesPath);
+	}
+
+	if (!state.frames.empty())
+	{
+		unsigned numFrames = (unsigned)state.frames.size();
+		printf("Frames:      %u\n", numFrames);
+		printf("Tick cycles: mean %llu max %u\n", (unsigned long long)(totalTick / numFrames), maxTick);
+		printf("Draw cycles: mean %llu max %u\n", (unsigned long long)(totalDraw / numFrames), maxDraw);
+		printf("Over %u cycle budget: %d frames\n", frameBudget, overBudget);
+	}
+
+	return cpuState == cpu_Crashed ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <algorithm>
+#include "FrameStats.h"
+
+FrameStats::FrameStats(const char* inName, uint32_t inBudgetMicros)
+	: name(inName), budgetMicros(inBudgetMicros)
+{
+}
+
+void FrameStats::AddFrame(uint32_t micros)
+{
+	window[windowPos] = micros;
+	windowPos = (windowPos + 1) % windowSize;
+	if (windowCount < windowSize)
+		windowCount++;
+
+	totalFrames++;
+	if (micros > budgetMicros)
+		totalOverBudget++;
+	if (micros > maxMicros)
+		maxMicros = micros;
+}
+
+void FrameStats::Print() const
+{
+	if (windowCount == 0)
+	{
+		return;
+	}
+
+	uint32_t sorted[windowSize];
+	std::copy(window, window + windowCount, sorted);
+	std::sort(sorted, sorted + windowCount);
+
+	auto percentile = [&](int p) { return sorted[(windowCount - 1) * p / 100]; };
+	int windowOverBudget = (int)(sorted + windowCount - std::upper_bound(sorted, sorted + windowCount, budgetMicros));
+
+	printf("%s (last %d frames, budget %.1f ms)\n", name, windowCount, budgetMicros / 1000.0f);
+	printf("  p50 %.2f ms  p95 %.2f ms  p99 %.2f ms  max %.2f ms\n",
+		percentile(50) / 1000.0f, percentile(95) / 1000.0f, percentile(99) / 1000.0f, sorted[windowCount - 1] / 1000.0f);
+	printf("  Over budget: %d of last %d, %u of %u since start (max %.2f ms)\n",
+		windowOverBudget, windowCount, totalOverBudget, totalFrames, maxMicros / 1000.0f);
+
+	// Buckets cover up to twice the budget, the last one also holds everything slower
+	uint32_t bucketWidth = (budgetMicros * 2) / numHistogramBuckets;
+	int buckets[numHistogramBuckets] = {};
+	int largestBucket = 0;
+
+	for (int n = 0; n < windowCount; n++)
+	{
+		int bucket = std::min((int)(sorted[n] / bucketWidth), numHistogramBuckets - 1);
+		buckets[bucket]++;
+		largestBucket = std::max(largestBucket, buckets[bucket]);
+	}
+
+	constexpr int maxBarLength = 50;
+
+	for (int n = 0; n < numHistogramBuckets; n++)
+	{
+		int barLength = (buckets[n] * maxBarLength + largestBucket - 1) / largestBucket;
+		printf("  %5.1f%s ms %c %5d ", (n * bucketWidth) / 1000.0f, n == numHistogramBuckets - 1 ? "+" : " ",
+			(n + 1) * bucketWidth > budgetMicros ? '!' : '|', buckets[n]);
+		for (int i = 0; i < barLength; i++)
+		{
+			putchar('#');
+		}
+		putchar('\n');
+	}
+}
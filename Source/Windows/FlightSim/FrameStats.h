@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+// Rolling frame time statistics for the host loop. Keeps the most recent frame times
+// for percentiles and a histogram, plus running totals since startup.
+class FrameStats
+{
+public:
+	static constexpr int windowSize = 1024;
+	static constexpr int numHistogramBuckets = 16;
+
+	FrameStats(const char* inName, uint32_t inBudgetMicros);
+
+	void AddFrame(uint32_t micros);
+	void Print() const;
+
+private:
+	const char* name;
+	uint32_t budgetMicros;
+
+	uint32_t window[windowSize];
+	int windowPos = 0;
+	int windowCount = 0;
+
+	uint32_t totalFrames = 0;
+	uint32_t totalOverBudget = 0;
+	uint32_t maxMicros = 0;
+};
@@ -7,6 +7,9 @@
 #include "Game.h"
 #include "Platform.h"
 #include "FixedMath.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "FrameStats.h"
 #include "lodepng.h"
 
 #define ZOOM_SCALE 1
@@ -24,6 +27,14 @@ bool isAudioEnabled = true;
 bool IsRecording = false;
 int CurrentRecordingFrame = 0;
 
+// F9 toggles recording an input replay, -replay FILE plays one back
+constexpr uint16_t RandomSeed = 0;
+const char* ReplayFilename = "replay.mfr";
+std::vector<uint8_t> PlaybackReplay;
+uint8_t PlaybackInput = 0;
+// Whether this tick's input came from the replay, which stops playing as its last input is read
+bool HasPlaybackInput = false;
+
 struct KeyMap
 {
 	SDL_Scancode key;
@@ -915,6 +926,11 @@ void Platform::SetAudioEnabled(bool isEnabled)
 
 uint8_t Platform::GetInput()
 {
+	if (HasPlaybackInput)
+	{
+		return PlaybackInput;
+	}
+
 	uint8_t inputMask = 0;
 
 	const uint8_t* keyStates = SDL_GetKeyboardState(NULL);
@@ -1094,15 +1110,40 @@ int main(int argc, char* argv[])
 	//DumpFont();
 
 	//SeedRandom((uint16_t)time(nullptr));
-	SeedRandom(0);
+	SeedRandom(RandomSeed);
 	Game::Init();
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (!strcmp(argv[n], "-replay") && n + 1 < argc)
+		{
+			if (Replay::Load(argv[++n], PlaybackReplay))
+			{
+				Replay::BeginPlayback(PlaybackReplay.data());
+			}
+		}
+	}
 	
 	bool running = true;
 	int playRate = 1;
 	static int testAudio = 0;
 
+	// Work is everything from Tick to present, interval is the time between successive frames
+	constexpr uint32_t frameBudgetMicros = 1000000 / TARGET_FRAMERATE;
+	FrameStats workStats("Frame work time", frameBudgetMicros);
+	FrameStats intervalStats("Frame interval", frameBudgetMicros);
+	const double ticksToMicros = 1000000.0 / SDL_GetPerformanceFrequency();
+	Uint64 lastFrameStart = 0;
+
 	while (running)
 	{
+		Uint64 frameStart = SDL_GetPerformanceCounter();
+		if (lastFrameStart)
+		{
+			intervalStats.AddFrame((uint32_t)((frameStart - lastFrameStart) * ticksToMicros));
+		}
+		lastFrameStart = frameStart;
+
 		SDL_Event event;
 		while (SDL_PollEvent(&event))
 		{
@@ -1125,6 +1166,25 @@ int main(int argc, char* argv[])
 				case SDLK_F11:
 					IsRecording = !IsRecording;
 					break;
+				case SDLK_F9:
+					if (Replay::IsRecording())
+					{
+						if (Replay::Save(ReplayFilename, Replay::EndRecording()))
+						{
+							printf("Wrote replay to %s\n", ReplayFilename);
+						}
+					}
+					else
+					{
+						// The camera is captured but the random state isn't, so reseed
+						SeedRandom(RandomSeed);
+						Replay::BeginRecording(RandomSeed);
+					}
+					break;
+				case SDLK_F10:
+					workStats.Print();
+					intervalStats.Print();
+					break;
 				}
 				break;
 			case SDL_KEYUP:
@@ -1140,10 +1200,26 @@ int main(int argc, char* argv[])
 		for (int n = 0; n < playRate; n++)
 		{
 			memset(ScreenSurface->pixels, 0, ScreenSurface->format->BytesPerPixel * ScreenSurface->w * ScreenSurface->h);
+
+#if PROFILER
+			Profiler::BeginFrame();
+#endif
 			
+			HasPlaybackInput = Replay::IsPlaying();
+			if (HasPlaybackInput)
+			{
+				PlaybackInput = Replay::NextInput();
+			}
+			Replay::RecordInput(Platform::GetInput());
+
 			Game::Tick();
 			Game::Draw();
 			//Map::DebugDraw();
+
+#if PROFILER
+			Profiler::EndFrame();
+			Profiler::DrawOverlay();
+#endif
 			
 			ResolveScreen(ScreenSurface);
 		}
@@ -1168,8 +1244,18 @@ int main(int argc, char* argv[])
 		SDL_RenderCopy(AppRenderer, ScreenTexture, &src, &dest);
 		SDL_RenderPresent(AppRenderer);
 
-		SDL_Delay(1000 / TARGET_FRAMERATE);
+		uint32_t workMicros = (uint32_t)((SDL_GetPerformanceCounter() - frameStart) * ticksToMicros);
+		workStats.AddFrame(workMicros);
+
+		// Only sleep for whatever is left of the frame budget
+		if (workMicros < frameBudgetMicros)
+		{
+			SDL_Delay((frameBudgetMicros - workMicros) / 1000);
+		}
 	}
 
+	workStats.Print();
+	intervalStats.Print();
+
 	return 0;
 }
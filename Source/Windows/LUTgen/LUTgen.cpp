@@ -66,7 +66,11 @@ int main(int argc, char* argv[])
 int main() 
 {
 	FILE* fs;
+#if _WIN32
 	fopen_s(&fs, "LUT.h", "w");
+#else
+	fs = fopen("LUT.h", "w");
+#endif
 
 	int8_t gen_sinTable[FIXED_ANGLE_MAX];
 